@@ -1,15 +1,35 @@
 #include "grid.h"
 #include <cstdlib> // std::free, std::calloc
+#ifdef GRID_GUARDED
+#include "guarded_alloc.h" // sampled guard-page allocations
+#include <cstdio>          // std::snprintf
+#define GRID_CALLOC guarded_calloc
+#define GRID_FREE guarded_free
+#else
+#define GRID_CALLOC std::calloc
+#define GRID_FREE std::free
+#endif
 void grid_init(GridType *grid) {
   grid->nx = 3;
   grid->ny = 4;
-  grid->data = (double *)std::calloc(grid->nx * grid->ny, sizeof(double));
+  grid->data = (double *)GRID_CALLOC(grid->nx * grid->ny, sizeof(double));
 }
 void grid_free(GridType *grid) {
-  std::free(grid->data);
+  GRID_FREE(grid->data);
   grid->nx = 0;
   grid->ny = 0;
 }
 double *grid_at(GridType *grid, int x, int y) {
+#ifdef GRID_GUARDED
+  if (guarded_owns(grid->data) &&
+      (x < 0 || x >= grid->nx || y < 0 || y >= grid->ny)) {
+    char what[96];
+    std::snprintf(what, sizeof(what),
+                  "grid_at(x=%d, y=%d) out of bounds of %dx%d grid", x, y,
+                  grid->nx, grid->ny);
+    // the address of the element, the allocation stack of the grid
+    guarded_report(&grid->data[x + grid->nx * y], what, grid->data);
+  }
+#endif
   return &grid->data[x + grid->nx * y];
 }
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "guarded_alloc.h"
+#include <csignal>    // sigaction
+#include <cstdint>    // SIZE_MAX
+#include <cstdio>     // std::snprintf
+#include <cstdlib>    // std::calloc, std::free, std::getenv, std::abort
+#include <cstring>    // std::memset, std::strlen
+#include <execinfo.h> // backtrace
+#include <mutex>
+#include <random>
+#include <sys/mman.h> // mmap, mprotect
+#include <unistd.h>   // sysconf, write
+
+GuardedPool guarded_pool = {nullptr, nullptr};
+
+namespace {
+
+constexpr std::size_t slot_count = 64;
+constexpr std::size_t slot_pages = 4; // larger allocations are not sampled
+constexpr std::size_t alignment = 16; // as std::calloc
+constexpr int max_frames = 16;
+
+struct Stack {
+  void *frames[max_frames];
+  int depth = 0;
+  void capture() { depth = backtrace(frames, max_frames); }
+};
+
+struct Slot {
+  char *ptr = nullptr; // nullptr: never used
+  std::size_t size = 0;
+  bool live = false;
+  Stack allocated;
+  Stack freed;
+};
+
+// [guard][slot 0][guard][slot 1] ... [slot n-1][guard]
+struct Pool {
+  std::size_t page = sysconf(_SC_PAGESIZE);
+  std::size_t stride = page * (slot_pages + 1);
+  std::size_t rate = 1000;
+  std::mutex mutex;
+  Slot slots[slot_count];
+  std::size_t next = 0; // round robin: freed slots are reused late
+  struct sigaction previous;
+
+  Pool();
+  char *data(std::size_t i) const {
+    return guarded_pool.begin + i * stride + page;
+  }
+};
+
+void print(const char *str) { // no stdio buffering in the signal handler
+  const ssize_t written = write(STDERR_FILENO, str, std::strlen(str));
+  (void)written;
+}
+
+void print(const char *title, const Stack &stack) {
+  print(title);
+  backtrace_symbols_fd(stack.frames, stack.depth, STDERR_FILENO);
+}
+
+Pool &pool();
+
+// the slot that 'addr' belongs to, best guess for addresses in guard pages
+Slot *find_slot(const char *addr, const char **kind) {
+  Pool &p = pool();
+  const std::size_t offset = addr - guarded_pool.begin;
+  std::size_t i = offset / p.stride;
+  const bool in_guard = offset % p.stride < p.page;
+  *kind = "heap-buffer-overflow";
+  if (in_guard && (i == slot_count || (i > 0 && p.slots[i - 1].live))) {
+    return &p.slots[i - 1]; // allocations are right-aligned to the guard
+  }
+  if (i == slot_count) {
+    return nullptr;
+  }
+  Slot &slot = p.slots[i];
+  if (!slot.live && slot.ptr) {
+    *kind = "heap-use-after-free";
+  } else if (addr < slot.ptr) {
+    *kind = "heap-buffer-underflow";
+  }
+  return &slot;
+}
+
+void report(const void *ptr, const char *what, const Slot *slot) {
+  char line[256];
+  std::snprintf(line, sizeof(line), "gridlib: %s at %p\n", what, ptr);
+  print(line);
+  Stack access;
+  access.capture();
+  print("access:\n", access);
+  if (slot && slot->ptr) {
+    std::snprintf(line, sizeof(line), "%zu-byte allocation at %p ",
+                  slot->size, static_cast<void *>(slot->ptr));
+    print(line);
+    print("allocated by:\n", slot->allocated);
+    if (!slot->live)
+      print("freed by:\n", slot->freed);
+  }
+}
+
+// returning from the handler repeats the faulting access, which is then
+// handled by the previous (usually the default) handler
+void on_fault(int, siginfo_t *info, void *) {
+  const char *addr = static_cast<const char *>(info->si_addr);
+  if (guarded_owns(addr)) {
+    const char *kind;
+    const Slot *slot = find_slot(addr, &kind);
+    report(addr, kind, slot);
+  }
+  sigaction(SIGSEGV, &pool().previous, nullptr);
+}
+
+void report_leaks() {
+  Pool &p = pool();
+  for (const Slot &slot : p.slots) {
+    if (slot.live) {
+      char line[128];
+      std::snprintf(line, sizeof(line), "gridlib: leak of %zu bytes ",
+                    slot.size);
+      print(line);
+      print("allocated by:\n", slot.allocated);
+    }
+  }
+}
+
+Pool::Pool() {
+  if (const char *env = std::getenv("GRID_GUARD_SAMPLE_RATE"))
+    rate = std::strtoul(env, nullptr, 10);
+  if (rate == 0)
+    return;
+  const std::size_t bytes = slot_count * stride + page;
+  void *region = mmap(nullptr, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS,
+                      -1, 0);
+  if (region == MAP_FAILED) {
+    rate = 0;
+    return;
+  }
+  guarded_pool.begin = static_cast<char *>(region);
+  guarded_pool.end = guarded_pool.begin + bytes;
+  Stack warmup; // backtrace allocates on its first call: not in the handler
+  warmup.capture();
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_sigaction = on_fault;
+  action.sa_flags = SA_SIGINFO;
+  sigaction(SIGSEGV, &action, &previous);
+  std::atexit(report_leaks);
+}
+
+Pool &pool() {
+  static Pool *instance = new Pool; // never destroyed: used at exit
+  return *instance;
+}
+
+// allocations until the next sampled one (0: not yet initialized)
+thread_local std::size_t countdown = 0;
+
+std::size_t next_countdown() {
+  const std::size_t rate = pool().rate;
+  if (rate <= 1)
+    return rate == 0 ? SIZE_MAX : 1; // disabled or every allocation
+  thread_local std::minstd_rand gen(std::random_device{}());
+  return 1 + gen() % (2 * rate); // mean 'rate', threads are not in lockstep
+}
+
+void *sample(std::size_t count, std::size_t size) {
+  Pool &p = pool();
+  if (count == 0 || size == 0 || count > slot_pages * p.page / size)
+    return nullptr;
+  const std::size_t bytes = count * size;
+  std::lock_guard<std::mutex> lock(p.mutex);
+  for (std::size_t k = 0; k < slot_count; ++k) {
+    const std::size_t i = (p.next + k) % slot_count;
+    Slot &slot = p.slots[i];
+    if (slot.live)
+      continue;
+    p.next = i + 1;
+    char *data = p.data(i);
+    if (mprotect(data, slot_pages * p.page, PROT_READ | PROT_WRITE) != 0)
+      return nullptr;
+    std::memset(data, 0, slot_pages * p.page);
+    const std::size_t padded = (bytes + alignment - 1) / alignment * alignment;
+    slot.ptr = data + slot_pages * p.page - padded; // right-aligned
+    slot.size = bytes;
+    slot.live = true;
+    slot.allocated.capture();
+    return slot.ptr;
+  }
+  return nullptr; // all slots in use
+}
+
+} // namespace
+
+void *guarded_calloc(std::size_t count, std::size_t size) {
+  if (countdown == 0) // first allocation of this thread
+    countdown = next_countdown();
+  if (--countdown != 0) // fast path: one decrement and compare
+    return std::calloc(count, size);
+  countdown = next_countdown();
+  if (void *ptr = sample(count, size))
+    return ptr;
+  return std::calloc(count, size);
+}
+
+void guarded_free(void *ptr) {
+  if (!guarded_owns(ptr)) {
+    std::free(ptr);
+    return;
+  }
+  Pool &p = pool();
+  std::lock_guard<std::mutex> lock(p.mutex);
+  const char *kind;
+  Slot *slot = find_slot(static_cast<char *>(ptr), &kind);
+  if (!slot->live || slot->ptr != ptr) {
+    guarded_report(ptr, slot->live ? "invalid free" : "double free");
+  }
+  slot->live = false;
+  slot->freed.capture();
+  const std::size_t i = slot - p.slots;
+  mprotect(p.data(i), slot_pages * p.page, PROT_NONE);
+}
+
+void guarded_report(const void *ptr, const char *what,
+                    const void *allocation) {
+  if (!allocation)
+    allocation = ptr;
+  const char *kind;
+  const Slot *slot =
+      guarded_owns(allocation)
+          ? find_slot(static_cast<const char *>(allocation), &kind)
+          : nullptr;
+  report(ptr, what, slot);
+  std::abort();
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// sampling guard-page allocator (GWP-ASan style) for production builds:
+// one in GRID_GUARD_SAMPLE_RATE allocations (environment, default 1000,
+// 0 disables) is placed at the end of its own page(s), directly before an
+// inaccessible guard page; out-of-bounds accesses and use after free of
+// sampled allocations fault and are reported with stack traces
+
+struct GuardedPool {
+  char *begin;
+  char *end;
+};
+extern GuardedPool guarded_pool; // address range of all guarded slots
+
+void *guarded_calloc(std::size_t count, std::size_t size);
+void guarded_free(void *ptr);
+
+// true if 'ptr' was sampled (one compare: cheap enough for every access)
+inline bool guarded_owns(const void *ptr) {
+  const auto begin = reinterpret_cast<std::uintptr_t>(guarded_pool.begin);
+  const auto end = reinterpret_cast<std::uintptr_t>(guarded_pool.end);
+  return reinterpret_cast<std::uintptr_t>(ptr) - begin < end - begin;
+}
+
+// prints 'what' at address 'ptr' with the current stack and the allocation
+// stack of 'allocation' (default: the allocation containing 'ptr'), then
+// aborts
+[[noreturn]] void guarded_report(const void *ptr, const char *what,
+                                 const void *allocation = nullptr);
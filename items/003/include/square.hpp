@@ -1,4 +1,10 @@
 #pragma once // this should always be the "first line" in a header file
+#include <cstddef> // std::size_t
 
 // declartion
 int square(const int); // compiler only needs function signature + name
+
+// out[i] = in[i] * in[i] for i < n (uses AVX2/AVX-512 if the CPU supports it)
+void square_n(const int *in, int *out, std::size_t n);
+void square_n(const float *in, float *out, std::size_t n);
+void square_n(const double *in, double *out, std::size_t n);
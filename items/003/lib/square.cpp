@@ -1,5 +1,10 @@
 #include "../include/square.hpp"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SQUARE_X86
+#endif
+
 // this provides the definition (actual functionality in the function body)
 int square(const int a) {
   return a * a;
@@ -9,4 +14,106 @@ void use_square(){
     auto res = square(5);
 }
 
-// clang++ -c lib/square.cpp -o square.o
\ No newline at end of file
+namespace {
+
+template <typename T> void square_scalar(const T *in, T *out, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = in[i] * in[i];
+  }
+}
+
+#ifdef SQUARE_X86
+// the 'target' attribute allows AVX instructions in a single function only:
+// the rest of the library still runs on any x86 CPU
+__attribute__((target("avx2"))) void square_avx2(const int *in, int *out,
+                                                 std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                        _mm256_mullo_epi32(v, v));
+  }
+  square_scalar(in + i, out + i, n - i); // remainder
+}
+__attribute__((target("avx2"))) void square_avx2(const float *in, float *out,
+                                                 std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 v = _mm256_loadu_ps(in + i);
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(v, v));
+  }
+  square_scalar(in + i, out + i, n - i);
+}
+__attribute__((target("avx2"))) void square_avx2(const double *in, double *out,
+                                                 std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d v = _mm256_loadu_pd(in + i);
+    _mm256_storeu_pd(out + i, _mm256_mul_pd(v, v));
+  }
+  square_scalar(in + i, out + i, n - i);
+}
+__attribute__((target("avx512f"))) void square_avx512(const int *in, int *out,
+                                                      std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512i v = _mm512_loadu_si512(in + i);
+    _mm512_storeu_si512(out + i, _mm512_mullo_epi32(v, v));
+  }
+  square_scalar(in + i, out + i, n - i);
+}
+__attribute__((target("avx512f"))) void
+square_avx512(const float *in, float *out, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512 v = _mm512_loadu_ps(in + i);
+    _mm512_storeu_ps(out + i, _mm512_mul_ps(v, v));
+  }
+  square_scalar(in + i, out + i, n - i);
+}
+__attribute__((target("avx512f"))) void
+square_avx512(const double *in, double *out, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512d v = _mm512_loadu_pd(in + i);
+    _mm512_storeu_pd(out + i, _mm512_mul_pd(v, v));
+  }
+  square_scalar(in + i, out + i, n - i);
+}
+#endif
+
+template <typename T> using Kernel = void (*)(const T *, T *, std::size_t);
+
+// picks the widest instruction set supported by the CPU (via cpuid)
+template <typename T> Kernel<T> select() {
+#ifdef SQUARE_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return static_cast<Kernel<T>>(square_avx512);
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return static_cast<Kernel<T>>(square_avx2);
+  }
+#endif
+  return square_scalar<T>;
+}
+
+} // namespace
+
+// the kernel is selected once, on first use (function-local statics are
+// initialized thread-safely and, unlike namespace-scope ones, also before a
+// call from a static initializer of another translation unit)
+void square_n(const int *in, int *out, std::size_t n) {
+  static const Kernel<int> kernel = select<int>();
+  kernel(in, out, n);
+}
+void square_n(const float *in, float *out, std::size_t n) {
+  static const Kernel<float> kernel = select<float>();
+  kernel(in, out, n);
+}
+void square_n(const double *in, double *out, std::size_t n) {
+  static const Kernel<double> kernel = select<double>();
+  kernel(in, out, n);
+}
+
+// clang++ -c lib/square.cpp -o square.o
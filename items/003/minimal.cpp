@@ -4,6 +4,11 @@
 int main() {
   const int b = square(13);
   std::cout << b << std::endl;
+
+  int in[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  int out[10];
+  square_n(in, out, 10); // one call for all values
+  std::cout << out[9] << std::endl;
   return 0;
 }
 
@@ -0,0 +1,279 @@
+#include "alloc_profiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <execinfo.h> // backtrace (glibc)
+#include <new>
+
+namespace alloc_profiler {
+namespace {
+
+std::atomic<std::size_t> g_allocs{0};
+std::atomic<std::size_t> g_frees{0};
+std::atomic<std::size_t> g_bytes{0};
+std::atomic<std::size_t> g_live{0};
+std::atomic<std::size_t> g_peak{0};
+std::atomic<std::size_t> g_sample_rate{0};
+
+thread_local Stats t_stats{};
+thread_local std::size_t t_countdown = 0;
+thread_local bool t_inside = false; // backtrace() may allocate itself
+
+// fixed-size table of sampled call stacks (no allocation while recording)
+constexpr std::size_t max_frames = 16;
+constexpr std::size_t max_stacks = 1024;
+struct Stack {
+  std::uint64_t hash;
+  int depth;
+  void *frames[max_frames];
+  std::size_t allocs;
+  std::size_t bytes;
+  std::size_t live_bytes; // sampled allocations not freed yet
+  std::size_t peak_bytes; // maximum of live_bytes
+};
+Stack g_stacks[max_stacks];
+std::atomic_flag g_stacks_lock = ATOMIC_FLAG_INIT;
+constexpr std::uint32_t no_stack = UINT32_MAX; // allocation not sampled
+
+// at most this many frames of the profiler itself are on top of the stack
+// (sample, record_alloc, allocate, allocate_or_throw, operator new)
+constexpr int max_skip = 8;
+
+// 'caller' is the return address of operator new: frames above it belong
+// to the profiler (inlining and tail calls change their number)
+[[gnu::noinline]] std::uint32_t sample(std::size_t size, void *caller) {
+  void *frames[max_frames + max_skip];
+  const int total = backtrace(frames, max_frames + max_skip);
+  int skip = 0;
+  while (skip < std::min(total, max_skip) && frames[skip] != caller) {
+    ++skip;
+  }
+  if (skip == std::min(total, max_skip)) {
+    skip = std::min(total, 3); // not found: sample, record_alloc, allocate
+  }
+  const int depth = std::min(total - skip, int(max_frames));
+  std::uint64_t hash = 14695981039346656037ull; // FNV-1a
+  for (int i = 0; i < depth; ++i) {
+    hash = (hash ^ reinterpret_cast<std::uintptr_t>(frames[i + skip])) *
+           1099511628211ull;
+  }
+  hash |= 1; // 0 marks an empty slot
+  std::uint32_t slot = no_stack;
+  while (g_stacks_lock.test_and_set(std::memory_order_acquire)) {
+  }
+  for (std::size_t i = 0; i < max_stacks; ++i) { // open addressing
+    Stack &stack = g_stacks[(hash + i) % max_stacks];
+    if (stack.hash == 0) {
+      stack.hash = hash;
+      stack.depth = depth;
+      std::memcpy(stack.frames, frames + skip, depth * sizeof(void *));
+    }
+    if (stack.hash == hash) {
+      ++stack.allocs;
+      stack.bytes += size;
+      stack.live_bytes += size;
+      stack.peak_bytes = std::max(stack.peak_bytes, stack.live_bytes);
+      slot = (hash + i) % max_stacks;
+      break;
+    } // table full: sample is dropped
+  }
+  g_stacks_lock.clear(std::memory_order_release);
+  return slot;
+}
+
+void release_sample(std::uint32_t slot, std::size_t size) {
+  while (g_stacks_lock.test_and_set(std::memory_order_acquire)) {
+  }
+  g_stacks[slot].live_bytes -= size;
+  g_stacks_lock.clear(std::memory_order_release);
+}
+
+// returns the stack slot of a sampled allocation or 'no_stack'
+[[gnu::noinline]] std::uint32_t record_alloc(std::size_t size,
+                                             void *caller) {
+  ++g_allocs;
+  g_bytes += size;
+  const std::size_t live = g_live += size;
+  std::size_t peak = g_peak;
+  while (live > peak && !g_peak.compare_exchange_weak(peak, live)) {
+  }
+  ++t_stats.allocs;
+  t_stats.bytes += size;
+  const std::size_t rate = g_sample_rate.load(std::memory_order_relaxed);
+  std::uint32_t slot = no_stack;
+  if (rate != 0 && !t_inside && ++t_countdown >= rate) {
+    t_countdown = 0;
+    t_inside = true;
+    slot = sample(size, caller);
+    t_inside = false;
+  }
+  return slot;
+}
+
+void record_free(std::size_t size) {
+  ++g_frees;
+  g_live -= size;
+  ++t_stats.frees;
+}
+
+// the size is stored in a header in front of the returned pointer
+struct Header {
+  std::size_t size;
+  std::uint32_t offset; // from start of the malloc'ed block to the pointer
+  std::uint32_t stack;  // slot in 'g_stacks' or 'no_stack'
+};
+static_assert(sizeof(Header) <= alignof(std::max_align_t));
+
+[[gnu::noinline]] void *allocate(std::size_t size, std::size_t align,
+                                 void *caller) {
+  // 'offset' keeps the user pointer aligned and leaves room for the header
+  const std::size_t offset = std::max(align, alignof(std::max_align_t));
+  void *block = align > alignof(std::max_align_t)
+                    ? std::aligned_alloc(align, offset + (size + align - 1) /
+                                                             align * align)
+                    : std::malloc(offset + size);
+  if (block == nullptr) {
+    return nullptr;
+  }
+  char *user = static_cast<char *>(block) + offset;
+  Header *header = reinterpret_cast<Header *>(user) - 1;
+  header->size = size;
+  header->offset = offset;
+  header->stack = record_alloc(size, caller);
+  return user;
+}
+
+void deallocate(void *ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  Header *header = static_cast<Header *>(ptr) - 1;
+  record_free(header->size);
+  if (header->stack != no_stack) {
+    release_sample(header->stack, header->size);
+  }
+  std::free(static_cast<char *>(ptr) - header->offset);
+}
+
+[[gnu::noinline]] void *allocate_or_throw(std::size_t size, std::size_t align,
+                                          void *caller) {
+  void *ptr = allocate(size, align, caller);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+} // namespace
+
+Stats global() {
+  return Stats{g_allocs, g_frees, g_bytes, g_live, g_peak};
+}
+
+Stats this_thread() { return t_stats; }
+
+void set_sample_rate(std::size_t n) { g_sample_rate = n; }
+
+void report(std::FILE *out, std::size_t top) {
+  const Stats stats = global();
+  std::fprintf(out,
+               "allocations: %zu, frees: %zu, bytes: %zu, live: %zu, "
+               "peak: %zu\n",
+               stats.allocs, stats.frees, stats.bytes, stats.live_bytes,
+               stats.peak_bytes);
+  while (g_stacks_lock.test_and_set(std::memory_order_acquire)) {
+  }
+  bool printed[max_stacks] = {};
+  for (std::size_t n = 0; n < top; ++n) { // selection of the top entries
+    std::size_t best = max_stacks;
+    for (std::size_t i = 0; i < max_stacks; ++i) {
+      if (g_stacks[i].hash != 0 && !printed[i] &&
+          (best == max_stacks || g_stacks[i].allocs > g_stacks[best].allocs))
+        best = i;
+    }
+    if (best == max_stacks) {
+      break;
+    }
+    printed[best] = true;
+    const Stack &stack = g_stacks[best];
+    std::fprintf(out,
+                 "--- sampled allocations: %zu, bytes: %zu, live: %zu, "
+                 "peak: %zu\n",
+                 stack.allocs, stack.bytes, stack.live_bytes,
+                 stack.peak_bytes);
+    std::fflush(out);
+    backtrace_symbols_fd(stack.frames, stack.depth, fileno(out));
+  }
+  g_stacks_lock.clear(std::memory_order_release);
+}
+
+Scope::Scope(const char *name, bool print)
+    : name(name), print(print), start(t_stats) {}
+
+Scope::~Scope() {
+  if (print) {
+    const Stats stats = delta();
+    std::fprintf(stderr, "%s: %zu allocations, %zu frees, %zu bytes\n", name,
+                 stats.allocs, stats.frees, stats.bytes);
+  }
+}
+
+Stats Scope::delta() const {
+  return Stats{t_stats.allocs - start.allocs, t_stats.frees - start.frees,
+               t_stats.bytes - start.bytes, 0, 0};
+}
+
+NoAllocations::NoAllocations(const char *name)
+    : name(name), start(t_stats.allocs) {}
+
+NoAllocations::~NoAllocations() {
+  if (t_stats.allocs != start) {
+    std::fprintf(stderr, "%s: expected no allocations, found %zu\n", name,
+                 t_stats.allocs - start);
+    std::abort();
+  }
+}
+
+} // namespace alloc_profiler
+
+// replacements of the global allocation functions
+using alloc_profiler::allocate;
+using alloc_profiler::allocate_or_throw;
+using alloc_profiler::deallocate;
+constexpr std::size_t default_align = alignof(std::max_align_t);
+#define CALLER __builtin_return_address(0) // return address in the program
+
+void *operator new(std::size_t size) {
+  return allocate_or_throw(size, default_align, CALLER);
+}
+void *operator new[](std::size_t size) {
+  return allocate_or_throw(size, default_align, CALLER);
+}
+void *operator new(std::size_t size, std::align_val_t align) {
+  return allocate_or_throw(size, static_cast<std::size_t>(align), CALLER);
+}
+void *operator new[](std::size_t size, std::align_val_t align) {
+  return allocate_or_throw(size, static_cast<std::size_t>(align), CALLER);
+}
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size, default_align, CALLER);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size, default_align, CALLER);
+}
+void operator delete(void *ptr) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  deallocate(ptr);
+}
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+  deallocate(ptr);
+}
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+  deallocate(ptr);
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+
+// global allocation profiler: linking alloc_profiler.cpp replaces the global
+// operator new/delete and counts every allocation of the program
+namespace alloc_profiler {
+
+struct Stats {
+  std::size_t allocs = 0;     // number of calls to operator new
+  std::size_t frees = 0;      // number of calls to operator delete
+  std::size_t bytes = 0;      // total bytes requested
+  std::size_t live_bytes = 0; // bytes currently allocated
+  std::size_t peak_bytes = 0; // maximum of live_bytes
+};
+
+Stats global();      // all threads since program start
+// calling thread only; live and peak bytes are 0: memory may be freed by
+// another thread than the one that allocated it, so they are only global
+Stats this_thread();
+
+// record the call stack of every n-th allocation (0 disables sampling)
+void set_sample_rate(std::size_t n);
+// print the sampled call stacks with the most allocations, including the
+// bytes still live and the peak of live bytes per stack
+void report(std::FILE *out = stderr, std::size_t top = 10);
+
+// RAII guard: counts allocations of the calling thread inside a scope
+class Scope {
+public:
+  explicit Scope(const char *name = "scope", bool print = true);
+  ~Scope();
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+  Stats delta() const; // allocations since construction (as this_thread)
+
+private:
+  const char *name;
+  bool print;
+  Stats start;
+};
+
+// RAII guard: aborts if the calling thread allocates inside the scope
+class NoAllocations {
+public:
+  explicit NoAllocations(const char *name = "region");
+  ~NoAllocations();
+  NoAllocations(const NoAllocations &) = delete;
+  NoAllocations &operator=(const NoAllocations &) = delete;
+
+private:
+  const char *name;
+  std::size_t start;
+};
+
+} // namespace alloc_profiler
@@ -0,0 +1,48 @@
+#include "alloc_profiler.hpp"
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct WidgetOwns {
+  double *data;
+  int size;
+  WidgetOwns(int size) : data(new double[size]), size(size) {}
+  WidgetOwns(const WidgetOwns &other) : WidgetOwns(other.size) {
+    std::copy(other.data, other.data + size, data);
+  }
+  WidgetOwns(WidgetOwns &&other)
+      : data(std::exchange(other.data, nullptr)), size(other.size) {}
+  ~WidgetOwns() { delete[] data; }
+};
+
+WidgetOwns by_value(WidgetOwns w) { return w; }
+
+int main() {
+  alloc_profiler::set_sample_rate(1); // record every call stack
+  {
+    WidgetOwns w1(10);
+    alloc_profiler::Scope scope("copies");
+    WidgetOwns w2(w1);                       // copy: allocates
+    WidgetOwns w3 = by_value(w1);            // copy into parameter, then move
+    WidgetOwns w4 = by_value(std::move(w2)); // no allocation
+  }
+  {
+    alloc_profiler::Scope scope("temporaries");
+    std::string s = "a string which does not fit into the SSO buffer";
+    for (int i = 0; i < 100; ++i) {
+      std::string tmp = s + "!"; // allocates a temporary in each iteration
+    }
+  }
+  {
+    std::vector<double> vec;
+    vec.reserve(1000);
+    alloc_profiler::NoAllocations guard("hot loop"); // aborts if violated
+    for (int i = 0; i < 1000; ++i) {
+      vec.push_back(i);
+    }
+  }
+  alloc_profiler::report(stderr, 3);
+}
+
+// g++ -std=c++17 -g -rdynamic alloc_profiler.cpp main.cpp -o main
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// a set of compile-time parameters (non-type template parameters)
+template <int UNROLL, int BLOCK, int PREFETCH> struct Config {
+  static constexpr int unroll = UNROLL;     // independent accumulators
+  static constexpr int block = BLOCK;       // elements per block
+  static constexpr int prefetch = PREFETCH; // distance in elements, 0: off
+  static_assert(BLOCK % UNROLL == 0, "BLOCK must be a multiple of UNROLL");
+};
+
+// kernel: dot product, specialized at compile time for each Config
+template <typename CONFIG>
+double dot(const double *a, const double *b, std::size_t n) {
+  double acc[CONFIG::unroll] = {};
+  std::size_t i = 0;
+  for (; i + CONFIG::block <= n; i += CONFIG::block) {
+    for (std::size_t j = i; j < i + CONFIG::block; j += CONFIG::unroll) {
+      if constexpr (CONFIG::prefetch > 0) {
+        __builtin_prefetch(a + j + CONFIG::prefetch);
+        __builtin_prefetch(b + j + CONFIG::prefetch);
+      }
+      for (int u = 0; u < CONFIG::unroll; ++u) { // unrolled by the compiler
+        acc[u] += a[j + u] * b[j + u];
+      }
+    }
+  }
+  for (; i < n; ++i) { // remainder
+    acc[0] += a[i] * b[i];
+  }
+  double sum = 0;
+  for (int u = 0; u < CONFIG::unroll; ++u) {
+    sum += acc[u];
+  }
+  return sum;
+}
+
+template <typename CONFIG> std::string describe() {
+  return "unroll=" + std::to_string(CONFIG::unroll) +
+         " block=" + std::to_string(CONFIG::block) +
+         " prefetch=" + std::to_string(CONFIG::prefetch);
+}
+
+// identifies the machine the cached result belongs to
+std::string machine() {
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.rfind("model name", 0) == 0) {
+      return line.substr(line.find(':') + 2) + " x" +
+             std::to_string(std::thread::hardware_concurrency());
+    }
+  }
+  return "unknown x" + std::to_string(std::thread::hardware_concurrency());
+}
+
+// instantiates the kernel for all CONFIGS, benchmarks them on first use and
+// dispatches to the fastest one through a function table
+template <typename... CONFIGS> struct Autotuned {
+  using Kernel = double (*)(const double *, const double *, std::size_t);
+  static constexpr std::array<Kernel, sizeof...(CONFIGS)> table = {
+      &dot<CONFIGS>...};
+  inline static const std::array<std::string, sizeof...(CONFIGS)> names = {
+      describe<CONFIGS>()...};
+
+  std::string name;  // key in the cache file
+  std::string cache; // path of the cache file
+  std::size_t best = sizeof...(CONFIGS);
+
+  Autotuned(std::string name, std::string cache = "autotune.cache")
+      : name(std::move(name)), cache(std::move(cache)) {}
+
+  double operator()(const double *a, const double *b, std::size_t n) {
+    if (best == sizeof...(CONFIGS)) {
+      tune();
+    }
+    return table[best](a, b, n);
+  }
+
+  void tune() {
+    const std::string key = name + "|" + signature() + "|" + machine();
+    { // cached result?
+      std::ifstream in(cache);
+      std::string line;
+      while (std::getline(in, line)) {
+        const auto sep = line.rfind('|');
+        if (sep != std::string::npos && line.substr(0, sep) == key) {
+          // invalid or truncated lines (e.g. from an interrupted run) are
+          // ignored
+          const char *first = line.data() + sep + 1;
+          const char *last = line.data() + line.size();
+          std::size_t index = 0;
+          auto [end, error] = std::from_chars(first, last, index);
+          if (error == std::errc() && end == last && end != first &&
+              index < table.size()) {
+            best = index;
+            return;
+          }
+        }
+      }
+    }
+    best = benchmark();
+    std::ofstream(cache, std::ios::app) << key << "|" << best << std::endl;
+  }
+
+  static std::string signature() {
+    std::string sig;
+    for (auto &&n : names) {
+      sig += n + ";";
+    }
+    return sig;
+  }
+
+  static std::size_t benchmark() {
+    using Clock = std::chrono::steady_clock;
+    using Duration = std::chrono::duration<double>;
+    const std::size_t n = 1 << 16;
+    std::vector<double> a(n, 1.0), b(n, 2.0);
+    [[maybe_unused]] volatile double sink = 0; // keeps the calls alive
+    std::size_t winner = 0;
+    double fastest = 0;
+    for (std::size_t k = 0; k < table.size(); ++k) {
+      sink = table[k](a.data(), b.data(), n); // warmup
+      double timespan = 1e300;
+      for (int rep = 0; rep < 20; ++rep) { // best of 20 runs
+        auto start = Clock::now();
+        sink = table[k](a.data(), b.data(), n);
+        timespan = std::min(timespan, Duration(Clock::now() - start).count());
+      }
+      if (k == 0 || timespan < fastest) {
+        fastest = timespan;
+        winner = k;
+      }
+    }
+    return winner;
+  }
+};
+
+int main() {
+  Autotuned<Config<1, 64, 0>, Config<4, 64, 0>, Config<8, 256, 0>,
+            Config<4, 256, 64>, Config<8, 1024, 128>>
+      dot_tuned("dot");
+  std::vector<double> a(1'000'000, 1.0), b(1'000'000, 3.0);
+  std::cout << dot_tuned(a.data(), b.data(), a.size()) << std::endl;
+  std::cout << "selected: " << dot_tuned.names[dot_tuned.best] << std::endl;
+}
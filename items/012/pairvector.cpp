@@ -0,0 +1,112 @@
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <utility>
+#include <vector>
+template <typename T> struct DebugType { using T::notexisting; };
+// usage: DebugType<decltype(...)> error;
+
+template <typename FIRST, typename SECOND> struct Pair {
+  FIRST first;
+  SECOND second;
+  Pair(const FIRST &first, const SECOND &second)
+      : first{first}, second{second} {}
+};
+
+// global operator overload for operator+(A,B)
+template <typename T, typename U, typename T2, typename U2>
+auto operator+(const Pair<T, U> &a, const Pair<T2, U2> &b) {
+  return Pair{a.first + b.first, a.second + b.second};
+}
+
+// 'first' and 'second' are stored in two separate contiguous arrays
+template <typename FIRST, typename SECOND> struct PairVector {
+  std::vector<FIRST> first;
+  std::vector<SECOND> second;
+
+  PairVector() = default;
+  PairVector(std::size_t size) : first(size), second(size) {}
+  std::size_t size() const { return first.size(); }
+  void push_back(const Pair<FIRST, SECOND> &pair) {
+    first.push_back(pair.first);
+    second.push_back(pair.second);
+  }
+
+  // proxy with the same member names as 'Pair', referring into the arrays
+  template <typename F, typename S> struct Reference {
+    F &first;
+    S &second;
+    operator Pair<FIRST, SECOND>() const { return Pair{first, second}; }
+    Reference &operator=(const Pair<FIRST, SECOND> &pair) {
+      first = pair.first;
+      second = pair.second;
+      return *this;
+    }
+  };
+
+  // zip iterator: advances both arrays in lockstep
+  template <typename F, typename S> struct Iterator {
+    F *first;
+    S *second;
+    Reference<F, S> operator*() { return {*first, *second}; }
+    Iterator &operator++() {
+      ++first;
+      ++second;
+      return *this;
+    }
+    bool operator!=(const Iterator &other) { return first != other.first; }
+  };
+  auto begin() {
+    return Iterator<FIRST, SECOND>{first.data(), second.data()};
+  }
+  auto end() {
+    return Iterator<FIRST, SECOND>{first.data() + size(),
+                                   second.data() + size()};
+  }
+  auto begin() const {
+    return Iterator<const FIRST, const SECOND>{first.data(), second.data()};
+  }
+  auto end() const {
+    return Iterator<const FIRST, const SECOND>{first.data() + size(),
+                                               second.data() + size()};
+  }
+  Reference<FIRST, SECOND> operator[](std::size_t idx) {
+    return {first[idx], second[idx]};
+  }
+};
+
+// element-wise sum: the result types follow operator+ of 'Pair' above;
+// each loop touches a single array per operand and is easy to vectorize
+template <typename T, typename U, typename T2, typename U2>
+auto operator+(const PairVector<T, U> &a, const PairVector<T2, U2> &b) {
+  assert(a.size() == b.size());
+  using Sum =
+      decltype(std::declval<Pair<T, U>>() + std::declval<Pair<T2, U2>>());
+  PairVector<decltype(Sum::first), decltype(Sum::second)> sum(a.size());
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    sum.first[i] = a.first[i] + b.first[i];
+  }
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    sum.second[i] = a.second[i] + b.second[i];
+  }
+  return sum;
+}
+
+int main() {
+  { // usaging different but compatible types
+    PairVector<int, double> v1;
+    PairVector<double, int> v2;
+    for (int i = 0; i < 4; ++i) {
+      v1.push_back(Pair(i, 2.0 * i));
+      v2.push_back(Pair(0.5 * i, i));
+    }
+    [[maybe_unused]] PairVector<double, double> sum = v1 + v2;
+    // DebugType<decltype(sum)> error;
+    for (auto &&pair : sum) {
+      std::cout << pair.first << " " << pair.second << std::endl;
+    }
+    v1[0] = Pair(7, 7.0);
+    Pair<int, double> p = v1[0];
+    std::cout << p.first << std::endl;
+  }
+}
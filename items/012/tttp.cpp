@@ -1,16 +1,47 @@
+#include <list>
 #include <memory>
+#include <memory_resource>
 #include <vector>
 template <typename T,
-          template <typename ...> class CONTAINER = std::vector>
+          template <typename ...> class CONTAINER = std::vector,
+          template <typename> class ALLOCATOR = std::allocator>
 struct Widget {
 //   std::vector<T, ...> ctnr;
-  CONTAINER<T> ctnr;
+  using allocator_type = ALLOCATOR<T>;
+  CONTAINER<T, ALLOCATOR<T>> ctnr;
+  Widget() = default;
+  explicit Widget(const allocator_type &alloc) : ctnr(alloc) {}
 };
 
 // specialization for T=double
-template <template <typename, typename> class CONTAINER>
-struct Widget<double, CONTAINER> {
-  CONTAINER<double, std::allocator<double>> ctnr;
+template <template <typename, typename> class CONTAINER,
+          template <typename> class ALLOCATOR>
+struct Widget<double, CONTAINER, ALLOCATOR> {
+  using allocator_type = ALLOCATOR<double>;
+  CONTAINER<double, ALLOCATOR<double>> ctnr;
+  Widget() = default;
+  explicit Widget(const allocator_type &alloc) : ctnr(alloc) {}
 };
 
-int main() { Widget<double, std::vector> w{}; }
+// Widget using a std::pmr::memory_resource
+template <typename T, template <typename...> class CONTAINER = std::vector>
+using PmrWidget = Widget<T, CONTAINER, std::pmr::polymorphic_allocator>;
+
+int main() {
+  Widget<double, std::vector> w{};
+  { // per-request arena: all memory is released at once at the end of scope
+    char buffer[1024]; // initial memory on the stack, then heap
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+    PmrWidget<double> w1(&arena);
+    PmrWidget<int, std::list> w2(&arena);
+    for (int i = 0; i < 100; ++i) {
+      w1.ctnr.push_back(i); // deallocation is a no-op for 'arena'
+      w2.ctnr.push_back(i);
+    }
+  }
+  { // pool of blocks of equal size, reused after deallocation
+    std::pmr::unsynchronized_pool_resource pool;
+    PmrWidget<int, std::list> w3(&pool);
+    w3.ctnr.assign(100, 1);
+  }
+}
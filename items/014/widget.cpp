@@ -1,28 +1,100 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <future>
 #include <iostream>
 #include <iterator>
 #include <list>
+#include <thread>
 #include <vector>
 
 struct Widget {
+  using Word = std::uint64_t;
+  static constexpr std::size_t bits = 64; // bits per word in 'active'
   std::vector<double> data;
-  std::vector<bool> active;
-  Widget(std::size_t size) : data(size, 0.0), active(size, false) {}
-  void set_value(std::size_t idx, double value) { data[idx] = value; }
-  void set_status(std::size_t idx, bool status) { active[idx] = status; }
+  std::vector<Word> active; // explicitly packed bitmap: bit i <-> data[i]
+  // optional dense view of the active set (unordered), maintained in O(1)
+  static constexpr std::size_t npos = -1;
+  bool dense;
+  std::vector<std::size_t> dense_idx;    // indices of active values
+  // compacted copy of active values; stale after mutable iteration (the
+  // iterators hand out double &), refreshed by 'active_values'
+  mutable std::vector<double> dense_values;
+  mutable bool dense_stale = false;
+  std::vector<std::size_t> dense_slot;   // idx -> position in dense_* or npos
+  Widget(std::size_t size, bool dense = false)
+      : data(size, 0.0), active((size + bits - 1) / bits, 0), dense(dense),
+        dense_slot(dense ? size : 0, npos) {}
+  void set_value(std::size_t idx, double value) {
+    data[idx] = value;
+    if (dense && dense_slot[idx] != npos)
+      dense_values[dense_slot[idx]] = value;
+  }
+  void set_status(std::size_t idx, bool status) {
+    const Word mask = Word{1} << (idx % bits);
+    if (dense && status != this->status(idx))
+      status ? dense_insert(idx) : dense_erase(idx);
+    if (status)
+      active[idx / bits] |= mask;
+    else
+      active[idx / bits] &= ~mask;
+  }
+  void dense_insert(std::size_t idx) {
+    dense_slot[idx] = dense_idx.size();
+    dense_idx.push_back(idx);
+    dense_values.push_back(data[idx]);
+  }
+  void dense_erase(std::size_t idx) { // swap with last and pop
+    const std::size_t slot = dense_slot[idx];
+    dense_idx[slot] = dense_idx.back();
+    dense_values[slot] = dense_values.back();
+    dense_slot[dense_idx[slot]] = slot;
+    dense_idx.pop_back();
+    dense_values.pop_back();
+    dense_slot[idx] = npos;
+  }
+  bool status(std::size_t idx) const {
+    return (active[idx / bits] >> (idx % bits)) & Word{1};
+  }
   void push_back(bool status, double value) {
     data.push_back(value);
-    active.push_back(status);
+    if (dense)
+      dense_slot.push_back(npos);
+    if (active.size() * bits < data.size())
+      active.push_back(0); // bits past data.size() are always zero
+    set_status(data.size() - 1, status);
+  }
+  std::size_t count_active() const { // O(n/64) using popcount per word
+    std::size_t count = 0;
+    for (Word word : active)
+      count += std::popcount(word);
+    return count;
   }
   struct IteratorActive {
     Widget &ref;
     std::size_t pos;
     std::size_t end;
     double &operator*() { return ref.data[pos]; }
-    IteratorActive &operator++() {
-      while (++pos != end) {
-        if (ref.active[pos])
-          break;
+    void seek(std::size_t from) { // first active position >= from, or end
+      if (from >= end) {
+        pos = end;
+        return;
+      }
+      const std::size_t last = (end + bits - 1) / bits;
+      std::size_t idx = from / bits;
+      // mask out bits before 'from' in the current word
+      Word word = ref.active[idx] & (~Word{0} << (from % bits));
+      while (word == 0) { // skips 64 inactive values per step
+        if (++idx == last) {
+          pos = end;
+          return;
+        }
+        word = ref.active[idx];
       }
+      pos = std::min(idx * bits + std::countr_zero(word), end);
+    }
+    IteratorActive &operator++() {
+      seek(pos + 1);
       return *this;
     }
     bool operator!=(const IteratorActive &other) {
@@ -30,14 +102,93 @@ struct Widget {
     }
   };
   IteratorActive begin_active() {
+    dense_stale = dense;
     IteratorActive iter = {*this, 0, data.size()};
-    return iter.ref.active[iter.pos] ? iter : ++iter;
+    iter.seek(0);
+    return iter;
   }
   IteratorActive end_active() {
     return IteratorActive{*this, data.size(), data.size()};
   }
+  // sub-range [first, last) of the values, iterating only the active ones
+  struct RangeActive {
+    Widget &ref;
+    std::size_t first;
+    std::size_t last;
+    IteratorActive begin() {
+      IteratorActive iter = {ref, first, last};
+      iter.seek(first);
+      return iter;
+    }
+    IteratorActive end() { return IteratorActive{ref, last, last}; }
+  };
+  // split into 'chunks' ranges holding (roughly) the same number of active
+  // values; boundaries are aligned to words of the bitmap
+  std::vector<RangeActive> split_active(std::size_t chunks) {
+    dense_stale = dense;
+    std::vector<std::size_t> prefix(active.size() + 1, 0); // per-word popcount
+    for (std::size_t i = 0; i < active.size(); ++i)
+      prefix[i + 1] = prefix[i] + std::popcount(active[i]);
+    const std::size_t total = prefix.back();
+    std::vector<RangeActive> ranges;
+    std::size_t first = 0;
+    for (std::size_t c = 1; c <= chunks; ++c) {
+      const std::size_t target = total * c / chunks;
+      const std::size_t word =
+          std::lower_bound(prefix.begin(), prefix.end(), target) -
+          prefix.begin();
+      const std::size_t last =
+          c == chunks ? data.size() : std::min(word * bits, data.size());
+      ranges.push_back(RangeActive{*this, first, std::max(first, last)});
+      first = std::max(first, last);
+    }
+    return ranges;
+  }
+  // O(active) iteration, requires 'dense'; order of visit is unspecified
+  struct IteratorDense {
+    Widget &ref;
+    std::size_t pos;
+    double &operator*() { return ref.data[ref.dense_idx[pos]]; }
+    IteratorDense &operator++() {
+      ++pos;
+      return *this;
+    }
+    bool operator!=(const IteratorDense &other) {
+      return this->pos != other.pos;
+    }
+  };
+  IteratorDense begin_dense() {
+    dense_stale = true;
+    return IteratorDense{*this, 0};
+  }
+  IteratorDense end_dense() { return IteratorDense{*this, dense_idx.size()}; }
+  // contiguous read-only copy of all active values (requires 'dense')
+  const std::vector<double> &active_values() const {
+    if (dense_stale) { // values may have been written through an iterator
+      for (std::size_t k = 0; k < dense_idx.size(); ++k)
+        dense_values[k] = data[dense_idx[k]];
+      dense_stale = false;
+    }
+    return dense_values;
+  }
 };
 
+// apply 'body' to all active values using 'num_threads' balanced chunks
+template <typename CALLABLE>
+void parallel_for_active(Widget &w, std::size_t num_threads, CALLABLE &&body) {
+  std::vector<std::future<void>> handles;
+  for (auto range : w.split_active(num_threads)) {
+    handles.push_back(std::async(std::launch::async, [range, &body]() mutable {
+      for (double &value : range) {
+        body(value);
+      }
+    }));
+  }
+  for (auto &&handle : handles) {
+    handle.get();
+  }
+}
+
 int main() {
   {
     Widget w(10);
@@ -53,4 +204,54 @@ int main() {
       [[maybe_unused]] double &value = *iter;
     }
   }
+  { // sparse: 1M values, every 1000th is active
+    Widget w(1'000'000);
+    for (std::size_t i = 0; i < w.data.size(); i += 1000) {
+      w.set_status(i, true);
+      w.set_value(i, i);
+    }
+    w.push_back(true, 1);
+    std::size_t visited = 0;
+    for (auto iter = w.begin_active(); iter != w.end_active(); ++iter) {
+      ++visited;
+    }
+    std::cout << visited << " == " << w.count_active() << std::endl;
+  }
+  { // same sparse Widget, 0.1% active, maintaining the dense view
+    Widget w(1'000'000, true);
+    for (std::size_t i = 0; i < w.data.size(); i += 1000) {
+      w.set_status(i, true);
+      w.set_value(i, i);
+    }
+    w.set_status(0, false);
+    double sum = 0;
+    for (auto iter = w.begin_dense(); iter != w.end_dense(); ++iter) {
+      sum += *iter; // touches only the active values
+    }
+    double sum_copy = 0;
+    for (double value : w.active_values()) {
+      sum_copy += value; // contiguous
+    }
+    std::cout << sum << " == " << sum_copy << std::endl;
+  }
+  { // process active values on all cores, load balanced by active count
+    Widget w(1'000'000);
+    for (std::size_t i = 0; i < w.data.size() / 10; ++i) {
+      w.set_status(i, true); // dense block at the front
+    }
+    for (std::size_t i = w.data.size() / 10; i < w.data.size(); i += 100) {
+      w.set_status(i, true); // sparse tail
+    }
+    const std::size_t num_threads =
+        std::max(1u, std::thread::hardware_concurrency());
+    for (auto range : w.split_active(num_threads)) {
+      std::size_t count = 0;
+      for (auto iter = range.begin(); iter != range.end(); ++iter) {
+        ++count;
+      }
+      std::cout << "[" << range.first << "," << range.last << "): " << count
+                << std::endl;
+    }
+    parallel_for_active(w, num_threads, [](double &value) { value += 1; });
+  }
 }
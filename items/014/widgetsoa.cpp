@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+struct Widget {
+  double m;
+  int id;
+  double weight;
+};
+
+template <auto MEMBER> struct MemberType; // type of a data member pointer
+template <typename C, typename T, T C::*MEMBER> struct MemberType<MEMBER> {
+  using type = T;
+  using class_type = C;
+};
+
+template <auto A, auto B> struct SameMember : std::false_type {};
+template <auto A> struct SameMember<A, A> : std::true_type {};
+
+// stores each member of the aggregate T in its own contiguous array
+template <typename T, auto... MEMBERS> struct SoA {
+  std::tuple<std::vector<typename MemberType<MEMBERS>::type>...> columns;
+
+  void push_back(const T &value) {
+    std::apply(
+        [&value](auto &... column) { (column.push_back(value.*MEMBERS), ...); },
+        columns);
+  }
+  std::size_t size() const { return std::get<0>(columns).size(); }
+
+  template <auto MEMBER> static constexpr std::size_t index() {
+    constexpr bool match[] = {SameMember<MEMBER, MEMBERS>::value...};
+    for (std::size_t i = 0; i < sizeof...(MEMBERS); ++i)
+      if (match[i])
+        return i;
+    return sizeof...(MEMBERS);
+  }
+  template <auto MEMBER> auto &column() { // only this array is touched
+    static_assert(index<MEMBER>() < sizeof...(MEMBERS), "unknown member");
+    return std::get<index<MEMBER>()>(columns);
+  }
+
+  // proxy reference for AoS-style access: w.get<&Widget::m>() = 1.0;
+  struct Reference {
+    SoA &ref;
+    std::size_t pos;
+    template <auto MEMBER> auto &get() { return ref.column<MEMBER>()[pos]; }
+    operator T() const { // gather
+      T value{};
+      std::apply(
+          [this, &value](auto &... column) {
+            ((value.*MEMBERS = column[pos]), ...);
+          },
+          ref.columns);
+      return value;
+    }
+    Reference &operator=(const T &value) { // scatter
+      std::apply(
+          [this, &value](auto &... column) {
+            ((column[pos] = value.*MEMBERS), ...);
+          },
+          ref.columns);
+      return *this;
+    }
+  };
+  Reference operator[](std::size_t pos) { return Reference{*this, pos}; }
+
+  struct Iterator {
+    SoA &ref;
+    std::size_t pos;
+    Reference operator*() { return Reference{ref, pos}; }
+    Iterator &operator++() {
+      ++pos;
+      return *this;
+    }
+    bool operator!=(const Iterator &other) { return pos != other.pos; }
+  };
+  Iterator begin() { return Iterator{*this, 0}; }
+  Iterator end() { return Iterator{*this, size()}; }
+};
+
+// count_if reading only the column of MEMBER
+template <auto MEMBER, typename T, auto... MEMBERS, typename PREDICATE>
+auto count_if(SoA<T, MEMBERS...> &soa, PREDICATE &&pred) {
+  auto &column = soa.template column<MEMBER>();
+  return std::count_if(column.begin(), column.end(), pred);
+}
+
+int main() {
+  SoA<Widget, &Widget::m, &Widget::id, &Widget::weight> vec;
+  vec.push_back(Widget{10, 0, 0.0});
+  vec.push_back(Widget{5, 1, 0.0});
+  vec.push_back(Widget{4, 2, 0.0});
+
+  int lower = 2;
+  int upper = 5;
+  auto lambda = [&t1 = lower, &t2 = upper](const double &m) {
+    return m > t1 && m < t2;
+  };
+  std::cout << count_if<&Widget::m>(vec, lambda) << std::endl;
+
+  // AoS-style access through proxy references
+  for (auto &&item : vec) {
+    item.get<&Widget::m>() += 1;
+  }
+  vec[0] = Widget{3, 7, 0.0};
+  Widget w = vec[1];
+  std::cout << w.m << " " << vec[0].get<&Widget::id>() << std::endl;
+}
@@ -0,0 +1,118 @@
+#include "inplace_function.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+template <typename CALLABLE, typename... ARGS>
+auto track_time(const std::string &name, int iter, CALLABLE &&func,
+                ARGS &&... args) {
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::duration<double>;
+  using TimePoint = std::chrono::time_point<std::chrono::steady_clock>;
+  func(std::forward<ARGS>(args)...); // warmup
+  TimePoint start = Clock::now();
+  for (int i = 0; i < iter; ++i)
+    func(std::forward<ARGS>(args)...);
+  TimePoint stop = Clock::now();
+  auto timespan = Duration(stop - start).count() / iter;
+  std::cout << name << ": " << std::scientific << timespan << "s" << std::endl;
+}
+
+struct Widget {
+  int i;
+};
+
+// worker queue with a non-allocating task type
+template <typename TASK> struct WorkQueue {
+  std::mutex m;
+  std::condition_variable v;
+  std::list<TASK> tasks;
+  bool shutdown = false;
+  void push(TASK task) {
+    {
+      std::lock_guard<std::mutex> lock(m);
+      tasks.push_back(std::move(task));
+    }
+    v.notify_one();
+  }
+  void work() {
+    while (true) {
+      TASK current;
+      {
+        std::unique_lock<std::mutex> lock(m);
+        v.wait(lock, [this] { return !tasks.empty() || shutdown; });
+        if (tasks.empty()) {
+          return; // shutdown
+        }
+        current = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      current();
+    }
+  }
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(m);
+      shutdown = true;
+    }
+    v.notify_all();
+  }
+};
+
+int function_ref_user(function_ref<int(int)> f) { return f(1); }
+
+int main() {
+  const int N = 1'000'000;
+  double g = 3;
+  double h = 4;
+  Widget w{3};
+  auto lambda = [=, &w](int b) { return g + h + w.i + b; }; // 24 bytes
+
+  { // construction (+ destruction) per call
+    double sum = 0;
+    track_time("construct std::function", N, [&] {
+      std::function<double(int)> f = lambda; // exceeds small buffer: allocates
+      sum += f(1);
+    });
+    track_time("construct inplace_function", N, [&] {
+      inplace_function<double(int), 32> f = lambda;
+      sum += f(1);
+    });
+    std::cout << sum << std::endl;
+  }
+  { // invocation
+    std::function<double(int)> std_func = lambda;
+    inplace_function<double(int), 32> inplace_func = lambda;
+    double sum = 0;
+    track_time("invoke std::function", N, [&] { sum += std_func(1); });
+    track_time("invoke inplace_function", N, [&] { sum += inplace_func(1); });
+    track_time("invoke function_ref", N,
+               [&] { sum += function_ref_user(lambda); });
+    std::cout << sum << std::endl;
+  }
+
+  { // task type of a worker queue, incl. move-only std::packaged_task
+    using Task = inplace_move_function<void(), 48>;
+    WorkQueue<Task> queue;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+      workers.emplace_back([&queue] { queue.work(); });
+    }
+    std::packaged_task<int()> task([] { return 42; });
+    auto future = task.get_future();
+    queue.push(std::move(task));
+    queue.push([&w] { ++w.i; });
+    std::cout << future.get() << std::endl;
+    queue.stop();
+    for (auto &&worker : workers) {
+      worker.join();
+    }
+  }
+}
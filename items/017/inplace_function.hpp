@@ -0,0 +1,157 @@
+#pragma once
+#include <cstddef>
+#include <functional> // std::bad_function_call
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// owning callable wrapper like std::function, but the callable is always
+// stored in an inline buffer of CAPACITY bytes: construction never allocates
+// (a too large closure type is a compile-time error); with COPYABLE = false
+// the wrapper is move-only and accepts move-only callables (e.g.
+// std::packaged_task), see 'inplace_move_function'
+template <typename SIG, std::size_t CAPACITY = 32,
+          std::size_t ALIGN = alignof(std::max_align_t), bool COPYABLE = true>
+class inplace_function;
+
+template <typename SIG, std::size_t CAPACITY = 32,
+          std::size_t ALIGN = alignof(std::max_align_t)>
+using inplace_move_function = inplace_function<SIG, CAPACITY, ALIGN, false>;
+
+template <typename R, typename... ARGS, std::size_t CAPACITY,
+          std::size_t ALIGN, bool COPYABLE>
+class inplace_function<R(ARGS...), CAPACITY, ALIGN, COPYABLE> {
+  struct VTable {
+    R (*invoke)(void *, ARGS &&...);
+    void (*copy)(void *dst, const void *src); // nullptr if move-only
+    void (*move)(void *dst, void *src);
+    void (*destroy)(void *);
+  };
+  template <typename F> static R invoke(void *f, ARGS &&... args) {
+    return (*static_cast<F *>(f))(std::forward<ARGS>(args)...);
+  }
+  template <typename F> static constexpr auto copy() {
+    using Copy = void (*)(void *, const void *);
+    if constexpr (COPYABLE && std::is_copy_constructible_v<F>) {
+      return Copy([](void *dst, const void *src) {
+        new (dst) F(*static_cast<const F *>(src));
+      });
+    } else {
+      return Copy(nullptr);
+    }
+  }
+  template <typename F> static void move(void *dst, void *src) {
+    new (dst) F(std::move(*static_cast<F *>(src)));
+  }
+  template <typename F> static void destroy(void *f) {
+    static_cast<F *>(f)->~F();
+  }
+  template <typename F>
+  static constexpr VTable vtable_for = {
+      &invoke<F>,
+      copy<F>(),
+      &move<F>,
+      &destroy<F>,
+  };
+
+  const VTable *vtable = nullptr;
+  alignas(ALIGN) unsigned char storage[CAPACITY];
+
+  // parameter type of the copy operations: if it is not inplace_function,
+  // they are no copy operations and the implicit ones are deleted
+  struct NotCopyable {};
+  using CopySource =
+      std::conditional_t<COPYABLE, inplace_function, NotCopyable>;
+
+public:
+  inplace_function() = default;
+  inplace_function(std::nullptr_t) {}
+  template <typename F, typename D = std::decay_t<F>,
+            typename = std::enable_if_t<
+                !std::is_same_v<D, inplace_function> &&
+                std::is_invocable_r_v<R, D &, ARGS...>>>
+  inplace_function(F &&f) {
+    static_assert(sizeof(D) <= CAPACITY, "increase CAPACITY");
+    static_assert(ALIGN % alignof(D) == 0, "callable alignment not supported");
+    static_assert(std::is_nothrow_move_constructible_v<D>);
+    static_assert(!COPYABLE || std::is_copy_constructible_v<D>,
+                  "move-only callable: use inplace_move_function");
+    new (storage) D(std::forward<F>(f));
+    vtable = &vtable_for<D>;
+  }
+  inplace_function(const CopySource &other) : vtable(other.vtable) {
+    if (vtable) {
+      vtable->copy(storage, other.storage);
+    }
+  }
+  inplace_function(inplace_function &&other) noexcept : vtable(other.vtable) {
+    if (vtable) {
+      vtable->move(storage, other.storage);
+      other.reset();
+    }
+  }
+  inplace_function &operator=(const CopySource &other) {
+    if (this != &other) {
+      inplace_function tmp(other);
+      *this = std::move(tmp);
+    }
+    return *this;
+  }
+  inplace_function &operator=(inplace_function &&other) noexcept {
+    if (this != &other) {
+      reset();
+      if (other.vtable) {
+        other.vtable->move(storage, other.storage);
+        vtable = other.vtable;
+        other.reset();
+      }
+    }
+    return *this;
+  }
+  template <typename F, typename D = std::decay_t<F>,
+            typename = std::enable_if_t<!std::is_same_v<D, inplace_function>>>
+  inplace_function &operator=(F &&f) { // constructs in place
+    reset();
+    return *new (this) inplace_function(std::forward<F>(f));
+  }
+  ~inplace_function() { reset(); }
+
+  void reset() {
+    if (vtable) {
+      vtable->destroy(storage);
+      vtable = nullptr;
+    }
+  }
+  explicit operator bool() const { return vtable != nullptr; }
+  R operator()(ARGS... args) {
+    if (!vtable) {
+      throw std::bad_function_call();
+    }
+    return vtable->invoke(storage, std::forward<ARGS>(args)...);
+  }
+};
+
+// non-owning reference to a callable object: two pointers, never allocates;
+// the referenced callable has to outlive the function_ref
+template <typename SIG> class function_ref;
+
+template <typename R, typename... ARGS> class function_ref<R(ARGS...)> {
+  void *object;
+  R (*invoke)(void *, ARGS...);
+
+public:
+  template <typename F, typename = std::enable_if_t<
+                            !std::is_same_v<std::decay_t<F>, function_ref> &&
+                            !std::is_function_v<std::remove_reference_t<F>> &&
+                            std::is_invocable_r_v<R, F &, ARGS...>>>
+  function_ref(F &&f)
+      : object(const_cast<void *>(
+            static_cast<const void *>(std::addressof(f)))),
+        invoke([](void *obj, ARGS... args) -> R {
+          return (*static_cast<std::remove_reference_t<F> *>(obj))(
+              std::forward<ARGS>(args)...);
+        }) {}
+  R operator()(ARGS... args) const {
+    return invoke(object, std::forward<ARGS>(args)...);
+  }
+};
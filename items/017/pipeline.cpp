@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+// lazy pipeline: 'from(vec) | filter(pred) | map(f) | reduce(init, op)'
+// each stage wraps the 'sink' of the next stage into a lambda: the terminal
+// operation builds a single nested closure and runs it in one pass over the
+// range (no intermediate containers, no type erasure, everything inlinable)
+namespace pipeline {
+
+template <typename RANGE, typename ADAPTER> struct Pipeline {
+  RANGE &range;
+  ADAPTER adapter; // sink of the next stage -> sink of this stage
+};
+
+struct Identity {
+  template <typename SINK> auto operator()(SINK sink) const { return sink; }
+};
+
+template <typename RANGE> auto from(RANGE &range) {
+  return Pipeline<RANGE, Identity>{range, Identity{}};
+}
+
+template <typename PREDICATE> struct Filter {
+  PREDICATE pred;
+  template <typename SINK> auto operator()(SINK sink) const {
+    return [pred = pred, sink](auto &&value) {
+      if (pred(value))
+        sink(value);
+    };
+  }
+};
+template <typename PREDICATE> auto filter(PREDICATE pred) {
+  return Filter<PREDICATE>{pred};
+}
+
+template <typename FUNCTION> struct Map {
+  FUNCTION func;
+  template <typename SINK> auto operator()(SINK sink) const {
+    return [func = func, sink](auto &&value) { sink(func(value)); };
+  }
+};
+template <typename FUNCTION> auto map(FUNCTION func) {
+  return Map<FUNCTION>{func};
+}
+
+// appending a stage composes the adapters
+template <typename RANGE, typename ADAPTER, typename STAGE>
+auto operator|(Pipeline<RANGE, ADAPTER> p, STAGE stage) {
+  auto adapter = [outer = p.adapter, stage](auto sink) {
+    return outer(stage(sink));
+  };
+  return Pipeline<RANGE, decltype(adapter)>{p.range, adapter};
+}
+
+template <typename T, typename OP> struct Reduce {
+  T init;
+  OP op;
+};
+template <typename T, typename OP> auto reduce(T init, OP op) {
+  return Reduce<T, OP>{init, op};
+}
+
+template <typename ADAPTER, typename ITER, typename T, typename OP>
+T run(const ADAPTER &adapter, ITER first, ITER last, T init, OP op) {
+  T acc = init;
+  auto sink = adapter([&acc, &op](auto &&value) { acc = op(acc, value); });
+  for (; first != last; ++first) {
+    sink(*first);
+  }
+  return acc;
+}
+
+// terminal: runs the pipeline
+template <typename RANGE, typename ADAPTER, typename T, typename OP>
+T operator|(Pipeline<RANGE, ADAPTER> p, Reduce<T, OP> r) {
+  return run(p.adapter, std::begin(p.range), std::end(p.range), r.init, r.op);
+}
+
+// parallel terminal: 'init' has to be the identity of the associative 'op'
+template <typename T, typename OP> struct ParallelReduce {
+  T init;
+  OP op;
+  std::size_t threads;
+};
+template <typename T, typename OP>
+auto parallel_reduce(T init, OP op, std::size_t threads = 0) { // 0: all cores
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  return ParallelReduce<T, OP>{init, op, threads};
+}
+
+template <typename RANGE, typename ADAPTER, typename T, typename OP>
+T operator|(Pipeline<RANGE, ADAPTER> p, ParallelReduce<T, OP> r) {
+  const auto size = std::distance(std::begin(p.range), std::end(p.range));
+  std::vector<std::future<T>> handles;
+  for (std::size_t t = 0; t < r.threads; ++t) { // one chunk per thread
+    auto first = std::next(std::begin(p.range), size * t / r.threads);
+    auto last = std::next(std::begin(p.range), size * (t + 1) / r.threads);
+    handles.push_back(std::async(std::launch::async, [&p, &r, first, last]() {
+      return run(p.adapter, first, last, r.init, r.op);
+    }));
+  }
+  T acc = r.init;
+  for (auto &&handle : handles) {
+    acc = r.op(acc, handle.get());
+  }
+  return acc;
+}
+
+} // namespace pipeline
+
+int main() {
+  using namespace pipeline;
+  struct Widget {
+    int m;
+  };
+  std::vector<Widget> vec{};
+  vec.push_back(Widget{10});
+  vec.push_back(Widget{5});
+  vec.push_back(Widget{4});
+
+  int lower = 2;
+  int upper = 5;
+  auto lambda = [&t1 = lower, &t2 = upper](const Widget &a) {
+    return a.m > t1 && a.m < t2;
+  };
+
+  { // count_if as a pipeline
+    auto count = from(vec) | filter(lambda) |
+                 reduce(0, [](int acc, const Widget &) { return acc + 1; });
+    std::cout << count << std::endl;
+  }
+  { // map-then-filter-then-sum in a single pass
+    auto sum = from(vec) | map([](const Widget &w) { return w.m * w.m; }) |
+               filter([](int m) { return m > 20; }) |
+               reduce(0, [](int acc, int m) { return acc + m; });
+    std::cout << sum << std::endl;
+  }
+  { // parallel terminal operation
+    std::vector<double> data(1'000'000, 1.0);
+    auto sum = from(data) | map([](double v) { return 2 * v; }) |
+               parallel_reduce(0.0, [](double a, double b) { return a + b; });
+    std::cout << sum << std::endl;
+  }
+}
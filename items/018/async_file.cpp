@@ -0,0 +1,94 @@
+#include "async_file.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// stand-in for real work on each chunk (e.g. json::index)
+std::uint64_t process(std::string_view chunk) {
+  std::uint64_t hash = 14695981039346656037ULL; // FNV-1a
+  for (unsigned char c : chunk) {
+    hash = (hash ^ c) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+auto closer = [](FILE *handle) { fclose(handle); };
+using File = std::unique_ptr<FILE, decltype(closer)>;
+
+// blocking: read and process strictly alternate
+std::uint64_t with_stdio(const char *name) {
+  File file(fopen(name, "rb"), closer);
+  std::uint64_t result = 0;
+  if (!file)
+    return result;
+  char buffer[4096];
+  while (std::size_t n = std::fread(buffer, 1, sizeof(buffer), file.get())) {
+    result += process(std::string_view(buffer, n));
+  }
+  return result;
+}
+
+// asynchronous: the next chunks are read while this one is processed
+std::uint64_t with_async(const char *name, async_io::Options options) {
+  auto file = async_io::File::open(name, options);
+  if (!file) {
+    std::cout << name << ": " << file.error().message() << std::endl;
+    return 0;
+  }
+  std::cout << "  (" << file->backend_name() << ")" << std::endl;
+  std::uint64_t result = 0;
+  while (true) {
+    auto chunk = file->next();
+    if (!chunk) {
+      std::cout << name << ": " << chunk.error().message() << std::endl;
+      break;
+    }
+    if (chunk->empty())
+      break;
+    for (std::size_t i = 0; i < chunk->size(); i += 4096) { // same work
+      result += process(chunk->substr(i, 4096));
+    }
+  }
+  return result;
+}
+
+template <typename CALLABLE>
+void track_time(const std::string &name, CALLABLE &&func) {
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::duration<double>;
+  auto start = Clock::now();
+  func();
+  auto stop = Clock::now();
+  std::cout << name << ": " << std::scientific << Duration(stop - start).count()
+            << "s" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  const char *name = argc > 1 ? argv[1] : "async_file.tmp";
+  if (argc == 1) { // 256 MiB test file
+    File file(fopen(name, "wb"), closer);
+    std::string block(std::size_t{1} << 20, 'x');
+    for (int i = 0; i < 256; ++i) {
+      block[i] = '\n';
+      std::fwrite(block.data(), 1, block.size(), file.get());
+    }
+  }
+  std::uint64_t a = 0, b = 0, c = 0, d = 0;
+  track_time("FILE* (fread 4 KiB)", [&] { a = with_stdio(name); });
+  async_io::Options options;
+  track_time("async (io_uring)", [&] { b = with_async(name, options); });
+  options.use_uring = false;
+  track_time("async (thread pool)", [&] { c = with_async(name, options); });
+  options.direct = true; // uncached reads: the overlap matters most here
+  options.use_uring = true;
+  track_time("async (io_uring, O_DIRECT)",
+             [&] { d = with_async(name, options); });
+  std::cout << (a == b && b == c && c == d) << std::endl;
+  if (argc == 1)
+    std::remove(name);
+}
+
+// g++ -std=c++17 -O2 async_file.cpp -pthread -o async_file
@@ -0,0 +1,395 @@
+#pragma once
+#include "expected.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+// sequential reader that keeps 'depth' large aligned reads in flight:
+// while the caller processes chunk n, chunks n+1 ... n+depth-1 are read;
+// io_uring (raw syscalls, no liburing) or a thread pool running 'pread'
+namespace async_io {
+
+inline std::error_code last_error() {
+  return std::error_code(errno, std::generic_category());
+}
+
+// owning file descriptor (same role as the FILE* unique_ptr in fileio.cpp)
+class FileDescriptor {
+  int fd = -1;
+
+public:
+  FileDescriptor() = default;
+  explicit FileDescriptor(int fd) : fd(fd) {}
+  FileDescriptor(FileDescriptor &&other) : fd(std::exchange(other.fd, -1)) {}
+  FileDescriptor &operator=(FileDescriptor &&other) {
+    std::swap(fd, other.fd);
+    return *this;
+  }
+  ~FileDescriptor() {
+    if (fd >= 0)
+      ::close(fd);
+  }
+  int get() const { return fd; }
+};
+
+auto deallocate = [](char *ptr) { std::free(ptr); };
+using Buffer = std::unique_ptr<char[], decltype(deallocate)>;
+
+// 'size' is rounded up to a multiple of 'alignment' (needed for O_DIRECT)
+inline Buffer allocate(std::size_t size, std::size_t alignment = 4096) {
+  size = (size + alignment - 1) / alignment * alignment;
+  return Buffer(static_cast<char *>(std::aligned_alloc(alignment, size)),
+                deallocate);
+}
+
+// ------------------------------------------------------------- backends
+
+// reads are identified by a slot number < depth; 'wait' returns the number
+// of bytes read into the slot's buffer or -errno
+class Backend {
+public:
+  virtual void submit(unsigned slot, int fd, char *buffer, std::size_t size,
+                      std::uint64_t offset) = 0;
+  virtual long wait(unsigned slot) = 0;
+  virtual const char *name() const = 0;
+  virtual ~Backend() = default;
+};
+
+// io_uring: one submission per read, completions may arrive in any order
+class Uring : public Backend {
+  FileDescriptor ring;
+  io_uring_params params{};
+  void *sq_ptr = MAP_FAILED;
+  void *cq_ptr = MAP_FAILED;
+  std::size_t sq_size = 0;
+  std::size_t cq_size = 0;
+  io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+  std::vector<long> results;
+  std::vector<char> done;
+
+  template <typename T> T *at(void *base, std::uint32_t offset) {
+    return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+  }
+  int enter(unsigned submit, unsigned min_complete, unsigned flags) {
+    return int(::syscall(__NR_io_uring_enter, ring.get(), submit,
+                         min_complete, flags, nullptr, 0));
+  }
+  void reap() {
+    auto head = at<std::uint32_t>(cq_ptr, params.cq_off.head);
+    auto tail = at<std::uint32_t>(cq_ptr, params.cq_off.tail);
+    auto mask = *at<std::uint32_t>(cq_ptr, params.cq_off.ring_mask);
+    auto cqes = at<io_uring_cqe>(cq_ptr, params.cq_off.cqes);
+    std::uint32_t h = *head;
+    for (; h != __atomic_load_n(tail, __ATOMIC_ACQUIRE); ++h) {
+      const io_uring_cqe &cqe = cqes[h & mask];
+      results[cqe.user_data] = cqe.res;
+      done[cqe.user_data] = 1;
+    }
+    __atomic_store_n(head, h, __ATOMIC_RELEASE);
+  }
+
+public:
+  Uring() = default;
+  Uring(const Uring &) = delete;
+  Uring &operator=(const Uring &) = delete;
+  ~Uring() {
+    if (sqes != MAP_FAILED)
+      ::munmap(sqes, params.sq_entries * sizeof(io_uring_sqe));
+    if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr)
+      ::munmap(cq_ptr, cq_size);
+    if (sq_ptr != MAP_FAILED)
+      ::munmap(sq_ptr, sq_size);
+  }
+
+  std::error_code setup(unsigned depth) {
+    ring = FileDescriptor(int(::syscall(__NR_io_uring_setup, depth, &params)));
+    if (ring.get() < 0)
+      return last_error(); // e.g. ENOSYS, EPERM (seccomp, containers)
+    sq_size = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+    cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+      sq_size = cq_size = std::max(sq_size, cq_size);
+    sq_ptr = ::mmap(nullptr, sq_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring.get(), IORING_OFF_SQ_RING);
+    if (sq_ptr == MAP_FAILED)
+      return last_error();
+    cq_ptr = sq_ptr;
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+      cq_ptr = ::mmap(nullptr, cq_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring.get(),
+                      IORING_OFF_CQ_RING);
+      if (cq_ptr == MAP_FAILED)
+        return last_error();
+    }
+    sqes = static_cast<io_uring_sqe *>(
+        ::mmap(nullptr, params.sq_entries * sizeof(io_uring_sqe),
+               PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.get(),
+               IORING_OFF_SQES));
+    if (sqes == MAP_FAILED)
+      return last_error();
+    results.assign(depth, 0);
+    done.assign(depth, 0);
+    return {};
+  }
+
+  void submit(unsigned slot, int fd, char *buffer, std::size_t size,
+              std::uint64_t offset) override {
+    auto tail = at<std::uint32_t>(sq_ptr, params.sq_off.tail);
+    auto mask = *at<std::uint32_t>(sq_ptr, params.sq_off.ring_mask);
+    auto array = at<std::uint32_t>(sq_ptr, params.sq_off.array);
+    const std::uint32_t index = *tail & mask;
+    io_uring_sqe &sqe = sqes[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READ;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uint64_t>(buffer);
+    sqe.len = std::uint32_t(size);
+    sqe.off = offset;
+    sqe.user_data = slot;
+    array[index] = index;
+    done[slot] = 0;
+    __atomic_store_n(tail, *tail + 1, __ATOMIC_RELEASE);
+    if (enter(1, 0, 0) < 0) {
+      results[slot] = -errno;
+      done[slot] = 1;
+    }
+  }
+  long wait(unsigned slot) override {
+    for (reap(); !done[slot]; reap()) {
+      if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+        return -errno;
+    }
+    return results[slot];
+  }
+  const char *name() const override { return "io_uring"; }
+};
+
+// fallback: blocking 'pread' on a few worker threads
+class ThreadPool : public Backend {
+  struct Request {
+    unsigned slot;
+    int fd;
+    char *buffer;
+    std::size_t size;
+    std::uint64_t offset;
+  };
+  std::mutex mutex;
+  std::condition_variable requested;
+  std::condition_variable completed;
+  std::deque<Request> queue;
+  std::vector<long> results;
+  std::vector<char> done;
+  bool stop = false;
+  std::vector<std::thread> workers;
+
+  static long read_all(const Request &r) {
+    std::size_t total = 0;
+    while (total < r.size) {
+      const ssize_t n =
+          ::pread(r.fd, r.buffer + total, r.size - total, r.offset + total);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n < 0)
+        return -errno;
+      if (n == 0)
+        break; // end of file
+      total += n;
+    }
+    return long(total);
+  }
+  void work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      requested.wait(lock, [this] { return stop || !queue.empty(); });
+      if (stop)
+        return;
+      const Request r = queue.front();
+      queue.pop_front();
+      lock.unlock();
+      const long result = read_all(r);
+      lock.lock();
+      results[r.slot] = result;
+      done[r.slot] = 1;
+      completed.notify_all();
+    }
+  }
+
+public:
+  ThreadPool(unsigned depth, unsigned threads)
+      : results(depth, 0), done(depth, 0) {
+    for (unsigned i = 0; i < threads; ++i)
+      workers.emplace_back(&ThreadPool::work, this);
+  }
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    requested.notify_all();
+    for (auto &&worker : workers)
+      worker.join();
+  }
+
+  void submit(unsigned slot, int fd, char *buffer, std::size_t size,
+              std::uint64_t offset) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      done[slot] = 0;
+      queue.push_back(Request{slot, fd, buffer, size, offset});
+    }
+    requested.notify_one();
+  }
+  long wait(unsigned slot) override {
+    std::unique_lock<std::mutex> lock(mutex);
+    completed.wait(lock, [this, slot] { return done[slot] != 0; });
+    return results[slot];
+  }
+  const char *name() const override { return "thread pool"; }
+};
+
+// ----------------------------------------------------------------- reader
+
+struct Options {
+  std::size_t chunk_size = std::size_t{1} << 20; // multiple of 4096
+  unsigned depth = 4;                            // reads in flight (> 0)
+  bool direct = false;                           // O_DIRECT: bypass cache
+  bool use_uring = true;                         // false: thread pool
+  unsigned threads = 2;                          // thread pool size
+};
+
+class File {
+  FileDescriptor fd;
+  Options options;
+  std::uint64_t file_size = 0;
+  std::uint64_t next_offset = 0; // of the next read to submit
+  unsigned current = 0;          // slot of the next chunk to return
+  bool pending_release = false;  // 'current - 1' can be reused
+  std::vector<Buffer> buffers;   // one per slot
+  std::vector<std::uint64_t> offsets;
+  std::vector<char> in_flight;
+  std::unique_ptr<Backend> backend;
+  std::error_code error; // sticky: returned by every 'next' after a failure
+
+  void submit(unsigned slot) {
+    if (next_offset >= file_size)
+      return;
+    offsets[slot] = next_offset;
+    in_flight[slot] = 1;
+    backend->submit(slot, fd.get(), buffers[slot].get(), options.chunk_size,
+                    next_offset);
+    next_offset += options.chunk_size;
+  }
+
+public:
+  // the backend actually used: io_uring if requested and available
+  const char *backend_name() const { return backend->name(); }
+  std::uint64_t size() const { return file_size; }
+
+  static expected<File, std::error_code> open(const char *name,
+                                              Options options = Options()) {
+    if (options.depth == 0 || options.chunk_size == 0)
+      return unexpected{std::make_error_code(std::errc::invalid_argument)};
+    File file;
+    file.options = options;
+    int flags = O_RDONLY | O_CLOEXEC;
+    if (options.direct)
+      file.fd = FileDescriptor(::open(name, flags | O_DIRECT));
+    if (file.fd.get() < 0)
+      file.fd = FileDescriptor(::open(name, flags)); // or not supported
+    if (file.fd.get() < 0)
+      return unexpected{last_error()};
+    struct stat st;
+    if (::fstat(file.fd.get(), &st) != 0)
+      return unexpected{last_error()};
+    file.file_size = st.st_size;
+    if (options.use_uring) {
+      auto uring = std::make_unique<Uring>();
+      if (!uring->setup(options.depth))
+        file.backend = std::move(uring);
+    }
+    if (!file.backend) {
+      file.backend =
+          std::make_unique<ThreadPool>(options.depth, options.threads);
+    }
+    for (unsigned slot = 0; slot < options.depth; ++slot) {
+      file.buffers.push_back(allocate(options.chunk_size));
+    }
+    file.offsets.assign(options.depth, 0);
+    file.in_flight.assign(options.depth, 0);
+    for (unsigned slot = 0; slot < options.depth; ++slot) {
+      file.submit(slot);
+    }
+    return file;
+  }
+
+  File() = default;
+  File(File &&) = default;
+  File &operator=(File &&) = delete;
+  ~File() { // in-flight reads must not write into released buffers
+    for (unsigned slot = 0; slot < in_flight.size(); ++slot) {
+      if (in_flight[slot])
+        backend->wait(slot);
+    }
+  }
+
+  // the next chunk in file order, empty at the end of the file; the data
+  // stays valid until the next call, which reuses its buffer for a new read
+  expected<std::string_view, std::error_code> next() {
+    if (error)
+      return unexpected{error}; // never an empty view (end of file)
+    if (pending_release) { // the caller is done with the previous chunk
+      submit((current + options.depth - 1) % options.depth);
+      pending_release = false;
+    }
+    const unsigned slot = current;
+    if (!in_flight[slot]) {
+      return std::string_view(); // end of file
+    }
+    const std::uint64_t offset = offsets[slot];
+    long n = backend->wait(slot);
+    in_flight[slot] = 0;
+    if (n < 0) {
+      error = std::error_code(int(-n), std::generic_category());
+      return unexpected{error};
+    }
+    // short read before the end of the file (rare): read the rest now, the
+    // next slot starts at 'offset + chunk_size'
+    const std::uint64_t expected_size =
+        std::min<std::uint64_t>(options.chunk_size, file_size - offset);
+    while (std::uint64_t(n) < expected_size) {
+      const ssize_t m = ::pread(fd.get(), buffers[slot].get() + n,
+                                expected_size - n, offset + n);
+      if (m < 0 && errno == EINTR)
+        continue;
+      if (m < 0) {
+        error = last_error();
+        return unexpected{error};
+      }
+      if (m == 0) // the file was truncated meanwhile
+        break;
+      n += m;
+    }
+    current = (current + 1) % options.depth;
+    pending_release = true;
+    return std::string_view(buffers[slot].get(), std::size_t(n));
+  }
+};
+
+} // namespace async_io
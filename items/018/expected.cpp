@@ -0,0 +1,87 @@
+#include "expected.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+enum class ParseError { empty, not_a_digit };
+
+// two versions of the same parse path: report failure by throwing ...
+int parse_throw(const std::string &str) {
+  if (str.empty())
+    throw std::invalid_argument("empty");
+  int value = 0;
+  for (char c : str) {
+    if (c < '0' || c > '9')
+      throw std::invalid_argument("not a digit");
+    value = value * 10 + (c - '0');
+  }
+  return value;
+}
+
+// ... or by returning the error
+expected<int, ParseError> parse_expected(const std::string &str) {
+  if (str.empty())
+    return unexpected{ParseError::empty};
+  int value = 0;
+  for (char c : str) {
+    if (c < '0' || c > '9')
+      return unexpected{ParseError::not_a_digit};
+    value = value * 10 + (c - '0');
+  }
+  return value;
+}
+
+// error is propagated through an intermediate frame in both versions
+int twice_throw(const std::string &str) { return 2 * parse_throw(str); }
+expected<int, ParseError> twice_expected(const std::string &str) {
+  return parse_expected(str).transform([](int v) { return 2 * v; });
+}
+
+template <typename CALLABLE>
+void track_time(const std::string &name, CALLABLE &&func) {
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::duration<double>;
+  func(); // warmup
+  auto start = Clock::now();
+  func();
+  auto stop = Clock::now();
+  std::cout << name << ": " << std::scientific << Duration(stop - start).count()
+            << "s" << std::endl;
+}
+
+int main() {
+  const int N = 1'000'000;
+  for (double rate : {0.0, 0.01, 0.1}) {
+    std::mt19937 gen(0);
+    std::bernoulli_distribution fail(rate);
+    std::vector<std::string> input;
+    for (int i = 0; i < N; ++i) {
+      input.push_back(fail(gen) ? "12x4" : "1234");
+    }
+    std::cout << "error rate " << std::defaultfloat << rate << std::endl;
+    long sum = 0;
+    int errors = 0;
+    track_time("  throw/catch", [&] {
+      for (auto &&str : input) {
+        try {
+          sum += twice_throw(str);
+        } catch (const std::invalid_argument &) {
+          ++errors;
+        }
+      }
+    });
+    track_time("  expected   ", [&] {
+      for (auto &&str : input) {
+        auto result = twice_expected(str);
+        if (result)
+          sum += *result;
+        else
+          ++errors;
+      }
+    });
+    std::cout << "  " << sum << " " << errors << std::endl;
+  }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+// minimal 'expected<T, E>' (see std::expected in C++23): holds either a
+// value or an error; errors are ordinary return values, no stack unwinding
+
+template <typename E> struct unexpected {
+  E error;
+};
+template <typename E> unexpected(E) -> unexpected<E>;
+
+struct bad_expected_access : std::exception {
+  const char *what() const noexcept override { return "bad expected access"; }
+};
+
+template <typename T, typename E> class expected {
+  std::variant<T, E> storage; // index 0: value, index 1: error
+
+public:
+  using value_type = T;
+  using error_type = E;
+
+  expected() : storage(std::in_place_index<0>) {}
+  expected(const T &value) : storage(std::in_place_index<0>, value) {}
+  expected(T &&value) : storage(std::in_place_index<0>, std::move(value)) {}
+  template <typename G>
+  expected(unexpected<G> err)
+      : storage(std::in_place_index<1>, std::move(err.error)) {}
+
+  bool has_value() const { return storage.index() == 0; }
+  explicit operator bool() const { return has_value(); }
+
+  T &value() & {
+    if (!has_value())
+      throw bad_expected_access();
+    return *std::get_if<0>(&storage);
+  }
+  const T &value() const & {
+    if (!has_value())
+      throw bad_expected_access();
+    return *std::get_if<0>(&storage);
+  }
+  T &&value() && { return std::move(value()); }
+  T &operator*() { return *std::get_if<0>(&storage); } // unchecked
+  const T &operator*() const { return *std::get_if<0>(&storage); }
+  T *operator->() { return std::get_if<0>(&storage); }
+  const T *operator->() const { return std::get_if<0>(&storage); }
+  const E &error() const { return *std::get_if<1>(&storage); } // unchecked
+  template <typename U> T value_or(U &&other) const & {
+    return has_value() ? **this : static_cast<T>(std::forward<U>(other));
+  }
+
+  // f: T -> expected<U, E>; errors are passed through
+  template <typename F> auto and_then(F &&f) & {
+    using R = std::invoke_result_t<F, T &>;
+    return has_value() ? std::forward<F>(f)(**this) : R(unexpected{error()});
+  }
+  template <typename F> auto and_then(F &&f) && {
+    using R = std::invoke_result_t<F, T &&>;
+    return has_value() ? std::forward<F>(f)(std::move(**this))
+                       : R(unexpected{error()});
+  }
+  // f: T -> U, result is expected<U, E>
+  template <typename F> auto transform(F &&f) & {
+    using R = expected<std::invoke_result_t<F, T &>, E>;
+    return has_value() ? R(std::forward<F>(f)(**this)) : R(unexpected{error()});
+  }
+  template <typename F> auto transform(F &&f) && {
+    using R = expected<std::invoke_result_t<F, T &&>, E>;
+    return has_value() ? R(std::forward<F>(f)(std::move(**this)))
+                       : R(unexpected{error()});
+  }
+  // f: E -> expected<T, E2>, called only for errors
+  template <typename F> auto or_else(F &&f) const & {
+    using R = std::invoke_result_t<F, const E &>;
+    return has_value() ? R(**this) : std::forward<F>(f)(error());
+  }
+};
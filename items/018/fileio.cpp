@@ -1,8 +1,24 @@
+#include "expected.hpp"
+#include "json.hpp"
+#include <cerrno>
 #include <cstdio>
 #include <iostream>
 #include <memory>
+#include <system_error>
 
-void parse(FILE *handle){};
+// number of JSON documents (e.g. newline-delimited) in the stream; values are
+// extracted on demand, see json.hpp
+expected<std::size_t, std::error_code> parse(FILE *handle) {
+  double total = 0;
+  auto count = json::for_each_document(handle, [&total](const json::Value &v) {
+    if (auto score = v["score"]) // documents without it are skipped
+      total += score.get_double();
+  });
+  if (count) {
+    std::cout << "total score: " << total << std::endl;
+  }
+  return count;
+};
 
 // int main() {
 //   auto filename = "data.json";
@@ -14,16 +30,26 @@ void parse(FILE *handle){};
 //   }
 // }
 
-auto open(const char *name, const char *mode) {
-  auto closer = [](FILE *handle) { fclose(handle); };
-  return std::unique_ptr<FILE, decltype(closer)>(fopen(name, mode), closer);
+auto closer = [](FILE *handle) { fclose(handle); };
+using File = std::unique_ptr<FILE, decltype(closer)>;
+
+// the error (e.g. 'No such file or directory') is not lost anymore
+expected<File, std::error_code> open(const char *name, const char *mode) {
+  FILE *handle = fopen(name, mode);
+  if (!handle) {
+    return unexpected{std::error_code(errno, std::generic_category())};
+  }
+  return File(handle, closer);
 };
 
 int main() {
   auto filename = "data.json";
   auto mode = "r";
-  auto file = open(filename, mode);
-  if (file) {
-    parse(file.get());
+  auto documents = open(filename, mode).and_then(
+      [](File file) { return parse(file.get()); });
+  if (documents) {
+    std::cout << *documents << " documents" << std::endl;
+  } else {
+    std::cout << filename << ": " << documents.error().message() << std::endl;
   }
 }
@@ -0,0 +1,151 @@
+#include "json.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// read-only memory mapping of a whole file, unmapped on destruction
+class Mapping {
+  void *data = MAP_FAILED;
+  std::size_t size = 0;
+
+public:
+  explicit Mapping(const char *name) {
+    int fd = ::open(name, O_RDONLY);
+    if (fd < 0)
+      return;
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+      size = st.st_size;
+      data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+  }
+  Mapping(const Mapping &) = delete;
+  Mapping &operator=(const Mapping &) = delete;
+  ~Mapping() {
+    if (data != MAP_FAILED)
+      ::munmap(data, size);
+  }
+  explicit operator bool() const { return data != MAP_FAILED; }
+  std::string_view view() const {
+    return {static_cast<const char *>(data), size};
+  }
+};
+
+// newline-delimited records similar to the daily input
+std::string generate(std::size_t bytes) {
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> score(0, 100);
+  std::string text;
+  for (long id = 0; text.size() < bytes; ++id) {
+    text += "{\"id\":" + std::to_string(id) + ",\"name\":\"user \\\"" +
+            std::to_string(gen() % 10000) + "\\\"\",\"score\":" +
+            std::to_string(score(gen)) + ",\"active\":" +
+            (gen() % 2 ? "true" : "false") +
+            ",\"tags\":[\"a\",\"bc\",\"def\"],\"parent\":null}\n";
+  }
+  return text;
+}
+
+template <typename CALLABLE>
+void track_time(const std::string &name, std::size_t bytes, CALLABLE &&func) {
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::duration<double>;
+  func(); // warmup
+  auto start = Clock::now();
+  func();
+  auto stop = Clock::now();
+  const double seconds = Duration(stop - start).count();
+  std::cout << name << ": " << std::scientific << seconds << "s "
+            << std::fixed << bytes / seconds * 1e-9 << " GB/s" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::string generated;
+  std::string_view text;
+  Mapping mapping(argc > 1 ? argv[1] : "");
+  if (argc > 1) {
+    if (!mapping) {
+      std::cout << argv[1] << ": cannot map file" << std::endl;
+      return 1;
+    }
+    text = mapping.view();
+  } else {
+    generated = generate(std::size_t{128} << 20);
+    text = generated;
+  }
+  std::cout << text.size() << " bytes" << std::endl;
+
+  // malformed objects and arrays: accessors must terminate and not crash
+  for (const char *bad :
+       {"{\"a\"}", "{:}", "{\"a\":}", "{\"a\":1,}", "[,]"}) {
+    auto doc = json::Document::parse(bad);
+    if (!doc)
+      continue;
+    std::size_t fields = 0;
+    doc->root().for_each_field(
+        [&fields](std::string_view, json::Value) { ++fields; });
+    std::cout << bad << ": " << doc->root()["a"].get_double() << " "
+              << doc->root().at(1).get_double() << " " << fields << std::endl;
+  }
+
+  std::size_t positions = 0;
+  track_time("stage 1 (index)", text.size(), [&] {
+    positions = json::index(text).value().size();
+  });
+  std::cout << "  " << positions << " positions" << std::endl;
+  // same in newline-aligned 1 MiB chunks: the position vector stays in cache
+  // and is not page-faulted in again (4 bytes per position)
+  track_time("stage 1 (index, 1 MiB chunks)", text.size(), [&] {
+    positions = 0;
+    for (std::size_t first = 0; first < text.size();) {
+      std::size_t last = text.find('\n', first + (std::size_t{1} << 20));
+      last = last == text.npos ? text.size() : last + 1;
+      positions += json::index(text.substr(first, last - first))->size();
+      first = last;
+    }
+  });
+
+  auto doc = json::Document::parse(text);
+  if (!doc) {
+    std::cout << std::make_error_code(doc.error()).message() << std::endl;
+    return 1;
+  }
+  track_time("stage 1 + 2 (parse)", text.size(), [&] {
+    doc = json::Document::parse(text);
+  });
+
+  double sum = 0;
+  long names = 0;
+  track_time("on demand (score, name)", text.size(), [&] {
+    doc->for_each_root([&sum, &names](const json::Value &record) {
+      sum += record["score"].get_double();
+      names += record["name"].raw_string().size();
+    });
+  });
+  track_time("full DOM", text.size(), [&] {
+    doc->for_each_root([&names](const json::Value &record) {
+      names += json::to_dom(record).v.index();
+    });
+  });
+
+  std::FILE *stream = std::tmpfile();
+  std::fwrite(text.data(), 1, text.size(), stream);
+  track_time("streaming (1 MiB chunks)", text.size(), [&] {
+    std::rewind(stream);
+    json::for_each_document(stream, [&sum](const json::Value &record) {
+      sum += record["score"].get_double();
+    });
+  });
+  std::fclose(stream);
+  std::cout << sum << " " << names << std::endl;
+}
+
+// g++ -std=c++20 -O2 -mavx2 json.cpp -o json
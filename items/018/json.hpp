@@ -0,0 +1,514 @@
+#pragma once
+#include "expected.hpp"
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <variant>
+#include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// two-stage JSON parser (simdjson-style):
+// 1) 'Indexer' classifies 64 bytes at a time into bit masks (SIMD if
+//    compiled with AVX2) and records the positions of all structural
+//    characters, string starts and scalar starts outside of strings
+// 2) 'Value' extracts values on demand by walking these positions;
+//    no tree is built unless 'to_dom' is called explicitly
+// only strings and bracket nesting are validated, not the full grammar
+namespace json {
+
+// ---------------------------------------------------------------- stage 1
+
+struct Masks {
+  std::uint64_t quote;      // '"'
+  std::uint64_t backslash;  // '\'
+  std::uint64_t structural; // '{' '}' '[' ']' ':' ','
+  std::uint64_t whitespace; // ' ' '\t' '\n' '\r'
+};
+
+inline Masks classify(const char *block) { // exactly 64 bytes
+#ifdef __AVX2__
+  const __m256i lo = _mm256_loadu_si256((const __m256i *)block);
+  const __m256i hi = _mm256_loadu_si256((const __m256i *)(block + 32));
+  auto eq = [&lo, &hi](char c) -> std::uint64_t {
+    const __m256i v = _mm256_set1_epi8(c);
+    return std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, v))) |
+           std::uint64_t(std::uint32_t(
+               _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, v))))
+               << 32;
+  };
+  return Masks{eq('"'), eq('\\'),
+               eq('{') | eq('}') | eq('[') | eq(']') | eq(':') | eq(','),
+               eq(' ') | eq('\t') | eq('\n') | eq('\r')};
+#else
+  Masks m{0, 0, 0, 0};
+  for (int i = 0; i < 64; ++i) {
+    const std::uint64_t bit = std::uint64_t{1} << i;
+    switch (block[i]) {
+    case '"':
+      m.quote |= bit;
+      break;
+    case '\\':
+      m.backslash |= bit;
+      break;
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case ':':
+    case ',':
+      m.structural |= bit;
+      break;
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+      m.whitespace |= bit;
+      break;
+    }
+  }
+  return m;
+#endif
+}
+
+// bit i of the result is the xor of bits 0..i of x
+inline std::uint64_t prefix_xor(std::uint64_t x) {
+  x ^= x << 1;
+  x ^= x << 2;
+  x ^= x << 4;
+  x ^= x << 8;
+  x ^= x << 16;
+  x ^= x << 32;
+  return x;
+}
+
+class Indexer {
+  std::uint64_t prev_escaped = 0;   // first char of next block is escaped
+  std::uint64_t prev_in_string = 0; // all ones if a string continues
+  std::uint64_t prev_scalar = 0;    // last char of block belongs to a scalar
+
+  // characters escaped by an odd number of preceding backslashes
+  std::uint64_t escaped(std::uint64_t backslash) {
+    if (backslash == 0) {
+      return std::exchange(prev_escaped, 0);
+    }
+    backslash &= ~prev_escaped;
+    const std::uint64_t follows_escape = backslash << 1 | prev_escaped;
+    const std::uint64_t even_bits = 0x5555555555555555ULL;
+    const std::uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+    std::uint64_t even_starts;
+    prev_escaped = __builtin_add_overflow(odd_starts, backslash, &even_starts);
+    return (even_bits ^ (even_starts << 1)) & follows_escape;
+  }
+
+public:
+  // appends positions (offset + i) of indexed characters in 'block'
+  void index(const char *block, std::uint32_t offset,
+             std::vector<std::uint32_t> &out) {
+    const Masks m = classify(block);
+    const std::uint64_t quote = m.quote & ~escaped(m.backslash);
+    // opening quote and string content are 'in_string', the closing not
+    const std::uint64_t in_string = prefix_xor(quote) ^ prev_in_string;
+    prev_in_string = std::uint64_t(std::int64_t(in_string) >> 63);
+    const std::uint64_t scalar =
+        ~(m.structural | m.whitespace | quote | in_string);
+    const std::uint64_t scalar_start = scalar & ~(scalar << 1 | prev_scalar);
+    prev_scalar = scalar >> 63;
+    std::uint64_t bits =
+        (m.structural & ~in_string) | (quote & in_string) | scalar_start;
+    // one resize per block instead of a capacity check per position
+    const std::size_t n = out.size();
+    out.resize(n + std::popcount(bits));
+    for (std::uint32_t *dst = out.data() + n; bits != 0; bits &= bits - 1) {
+      *dst++ = offset + std::countr_zero(bits);
+    }
+  }
+  bool in_string() const { return prev_in_string != 0; }
+};
+
+// positions of all structural characters and value starts in 'text'
+inline expected<std::vector<std::uint32_t>, std::errc>
+index(std::string_view text) {
+  if (text.size() >= UINT32_MAX) {
+    return unexpected{std::errc::value_too_large}; // use 'for_each_document'
+  }
+  std::vector<std::uint32_t> positions;
+  positions.reserve(text.size() / 4);
+  Indexer indexer;
+  std::size_t i = 0;
+  for (; i + 64 <= text.size(); i += 64) {
+    indexer.index(text.data() + i, i, positions);
+  }
+  char tail[64];
+  std::memset(tail, ' ', sizeof(tail));
+  std::memcpy(tail, text.data() + i, text.size() - i);
+  indexer.index(tail, i, positions);
+  if (indexer.in_string()) {
+    return unexpected{std::errc::illegal_byte_sequence}; // unterminated
+  }
+  return positions;
+}
+
+// ---------------------------------------------------------------- stage 2
+
+class Value;
+
+class Document {
+  friend class Value;
+  std::string_view text;
+  std::vector<std::uint32_t> pos;   // from stage 1
+  std::vector<std::uint32_t> after; // pos index following each value
+
+public:
+  // 'text' has to outlive the document (no copy is made)
+  static expected<Document, std::errc> parse(std::string_view text) {
+    auto positions = index(text);
+    if (!positions) {
+      return unexpected{positions.error()};
+    }
+    Document doc;
+    doc.text = text;
+    doc.pos = std::move(*positions);
+    doc.pos.push_back(text.size()); // sentinel
+    // match brackets: validates nesting, makes skipping a value O(1)
+    doc.after.resize(doc.pos.size());
+    doc.after.back() = doc.pos.size(); // skipping the sentinel ends any walk
+    std::vector<std::uint32_t> open;
+    for (std::uint32_t i = 0; i + 1 < doc.pos.size(); ++i) {
+      const char c = text[doc.pos[i]];
+      doc.after[i] = i + 1;
+      if (c == '{' || c == '[') {
+        open.push_back(i);
+      } else if (c == '}' || c == ']') {
+        const char expected_open = c == '}' ? '{' : '[';
+        if (open.empty() || text[doc.pos[open.back()]] != expected_open)
+          return unexpected{std::errc::illegal_byte_sequence};
+        doc.after[open.back()] = i + 1;
+        open.pop_back();
+      }
+    }
+    if (!open.empty()) {
+      return unexpected{std::errc::illegal_byte_sequence};
+    }
+    return doc;
+  }
+  Value root() const;
+  // top-level values, e.g. of newline-delimited JSON
+  template <typename FUNC> void for_each_root(FUNC &&func) const;
+};
+
+class Value {
+  const Document *doc = nullptr;
+  std::uint32_t i = 0; // index into doc->pos
+
+  char first() const { return doc->text[doc->pos[i]]; }
+  const char *begin() const { return doc->text.data() + doc->pos[i]; }
+  const char *end() const { return doc->text.data() + doc->text.size(); }
+  // 'key' ':' value starts at position k, before the closing bracket 'last'
+  // (malformed objects such as {"a"} or {:} end the walk)
+  bool is_field(std::uint32_t k, std::uint32_t last) const {
+    return k + 2 < last && doc->text[doc->pos[k + 1]] == ':';
+  }
+
+public:
+  enum class Type { invalid, object, array, string, number, boolean, null };
+  Value() = default;
+  Value(const Document *doc, std::uint32_t i) : doc(doc), i(i) {}
+
+  explicit operator bool() const { return doc != nullptr; }
+  std::uint32_t next() const { return doc->after[i]; } // skips this value
+  Type type() const {
+    if (!doc)
+      return Type::invalid;
+    switch (first()) {
+    case '{':
+      return Type::object;
+    case '[':
+      return Type::array;
+    case '"':
+      return Type::string;
+    case 't':
+    case 'f':
+      return Type::boolean;
+    case 'n':
+      return Type::null;
+    default:
+      return Type::number;
+    }
+  }
+
+  // accessors of the wrong type (or of an invalid Value) return a default
+  // string content without the quotes, escape sequences are not processed
+  std::string_view raw_string() const {
+    if (type() != Type::string)
+      return {};
+    // closing quote: last '"' before the next indexed position
+    const char *last = doc->text.data() + doc->pos[i + 1];
+    while (*--last != '"') {
+    }
+    return {begin() + 1, std::size_t(last - begin() - 1)};
+  }
+  std::string get_string() const {
+    const std::string_view raw = raw_string();
+    std::string str;
+    str.reserve(raw.size());
+    for (std::size_t k = 0; k < raw.size(); ++k) {
+      if (raw[k] != '\\') {
+        str += raw[k];
+        continue;
+      }
+      switch (raw[++k]) {
+      case 'b':
+        str += '\b';
+        break;
+      case 'f':
+        str += '\f';
+        break;
+      case 'n':
+        str += '\n';
+        break;
+      case 'r':
+        str += '\r';
+        break;
+      case 't':
+        str += '\t';
+        break;
+      case 'u': { // BMP code point to UTF-8 (surrogate pairs not combined)
+        unsigned cp = 0;
+        std::from_chars(raw.data() + k + 1, raw.data() + k + 5, cp, 16);
+        k += 4;
+        if (cp < 0x80) {
+          str += char(cp);
+        } else if (cp < 0x800) {
+          str += char(0xC0 | cp >> 6);
+          str += char(0x80 | (cp & 0x3F));
+        } else {
+          str += char(0xE0 | cp >> 12);
+          str += char(0x80 | (cp >> 6 & 0x3F));
+          str += char(0x80 | (cp & 0x3F));
+        }
+        break;
+      }
+      default: // '"' '\\' '/'
+        str += raw[k];
+      }
+    }
+    return str;
+  }
+  double get_double() const {
+    double value = 0;
+    if (type() == Type::number)
+      std::from_chars(begin(), end(), value);
+    return value;
+  }
+  std::int64_t get_int64() const {
+    std::int64_t value = 0;
+    if (type() == Type::number)
+      std::from_chars(begin(), end(), value);
+    return value;
+  }
+  bool get_bool() const { return type() == Type::boolean && first() == 't'; }
+  bool is_null() const { return type() == Type::null; }
+
+  // arrays: func(Value) for each element
+  template <typename FUNC> void for_each_element(FUNC &&func) const {
+    if (type() != Type::array)
+      return;
+    const std::uint32_t last = next() - 1; // closing bracket
+    for (std::uint32_t k = i + 1; k < last;) {
+      const Value element(doc, k);
+      func(element);
+      k = element.next() + 1; // skip ','
+    }
+  }
+  // objects: func(std::string_view key, Value) for each field
+  template <typename FUNC> void for_each_field(FUNC &&func) const {
+    if (type() != Type::object)
+      return;
+    const std::uint32_t last = next() - 1;
+    for (std::uint32_t k = i + 1; is_field(k, last);) {
+      const Value key(doc, k), value(doc, k + 2); // skip ':'
+      func(key.raw_string(), value);
+      k = value.next() + 1;
+    }
+  }
+  // object field (linear search, unescaped key), invalid Value if missing
+  Value operator[](std::string_view key) const {
+    if (type() != Type::object)
+      return Value();
+    const std::uint32_t last = next() - 1;
+    for (std::uint32_t k = i + 1; is_field(k, last);) {
+      const Value value(doc, k + 2);
+      if (Value(doc, k).raw_string() == key)
+        return value;
+      k = value.next() + 1;
+    }
+    return Value();
+  }
+  // array element n (linear), invalid Value if out of range
+  Value at(std::size_t n) const {
+    if (type() != Type::array)
+      return Value();
+    const std::uint32_t last = next() - 1;
+    for (std::uint32_t k = i + 1; k < last; --n) {
+      const Value element(doc, k);
+      if (n == 0)
+        return element;
+      k = element.next() + 1;
+    }
+    return Value();
+  }
+};
+
+inline Value Document::root() const {
+  return pos.size() > 1 ? Value(this, 0) : Value();
+}
+
+template <typename FUNC> void Document::for_each_root(FUNC &&func) const {
+  for (std::uint32_t k = 0; k + 1 < pos.size();) {
+    const Value value(this, k);
+    func(value);
+    k = value.next();
+  }
+}
+
+// ---------------------------------------------------------- optional DOM
+
+struct Node {
+  using Array = std::vector<Node>;
+  using Object = std::vector<std::pair<std::string, Node>>;
+  std::variant<std::nullptr_t, bool, double, std::string, Array, Object> v;
+};
+
+inline Node to_dom(const Value &value) {
+  switch (value.type()) {
+  case Value::Type::object: {
+    Node::Object object;
+    value.for_each_field([&object](std::string_view key, const Value &v) {
+      object.emplace_back(std::string(key), to_dom(v));
+    });
+    return Node{std::move(object)};
+  }
+  case Value::Type::array: {
+    Node::Array array;
+    value.for_each_element(
+        [&array](const Value &v) { array.push_back(to_dom(v)); });
+    return Node{std::move(array)};
+  }
+  case Value::Type::string:
+    return Node{value.get_string()};
+  case Value::Type::number:
+    return Node{value.get_double()};
+  case Value::Type::boolean:
+    return Node{value.get_bool()};
+  default:
+    return Node{nullptr};
+  }
+}
+
+// ------------------------------------------------------------- streaming
+
+// finds where the stream can be cut between two top-level values; the
+// bracket depth and string state are carried from one chunk to the next
+class Splitter {
+  std::size_t depth = 0;
+  bool in_string = false;
+  bool escaped = false;
+
+public:
+  // scans text[from, size), returns the position after the last complete
+  // top-level value in text[0, size), 0 if there is none
+  std::size_t scan(const char *text, std::size_t from, std::size_t size) {
+    std::size_t cut = 0;
+    for (std::size_t i = from; i < size; ++i) {
+      const char c = text[i];
+      if (in_string) {
+        if (escaped)
+          escaped = false;
+        else if (c == '\\')
+          escaped = true;
+        else if (c == '"')
+          in_string = false;
+        continue;
+      }
+      switch (c) {
+      case '"':
+        in_string = true;
+        break;
+      case '{':
+      case '[':
+        ++depth;
+        break;
+      case '}':
+      case ']':
+        if (depth > 0 && --depth == 0)
+          cut = i + 1;
+        break;
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r':
+        if (depth == 0) // after a top-level scalar or string
+          cut = i;
+        break;
+      }
+    }
+    return cut;
+  }
+};
+
+// concatenated JSON values (e.g. newline-delimited) from a stream in chunks
+// of bounded size: each chunk ends after a complete top-level value, the
+// incomplete rest is carried over to the next chunk
+template <typename FUNC>
+expected<std::size_t, std::error_code>
+for_each_document(FILE *handle, FUNC &&func,
+                  std::size_t chunk_size = std::size_t{1} << 20) {
+  std::vector<char> buffer(chunk_size);
+  Splitter splitter;
+  std::size_t filled = 0;
+  std::size_t scanned = 0; // buffer[0, scanned) was seen by 'splitter'
+  std::size_t count = 0;
+  bool eof = false;
+  while (!eof) {
+    filled += std::fread(buffer.data() + filled, 1, buffer.size() - filled,
+                         handle);
+    eof = filled < buffer.size();
+    if (std::ferror(handle)) {
+      return unexpected{std::make_error_code(std::errc::io_error)};
+    }
+    std::size_t end = filled;
+    if (!eof) {
+      end = splitter.scan(buffer.data(), scanned, filled);
+      scanned = filled;
+      if (end == 0) { // a single document larger than the buffer
+        if (buffer.size() >= UINT32_MAX / 2) { // cannot be indexed
+          return unexpected{std::make_error_code(std::errc::value_too_large)};
+        }
+        buffer.resize(buffer.size() * 2);
+        continue;
+      }
+    }
+    auto doc = Document::parse(std::string_view(buffer.data(), end));
+    if (!doc) {
+      return unexpected{std::make_error_code(doc.error())};
+    }
+    doc->for_each_root([&func, &count](const Value &value) {
+      func(value);
+      ++count;
+    });
+    std::memmove(buffer.data(), buffer.data() + end, filled - end);
+    filled -= end;
+    scanned -= end;
+  }
+  return count;
+}
+
+} // namespace json
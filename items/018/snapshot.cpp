@@ -0,0 +1,87 @@
+#include "snapshot.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Config {
+  int version = 0;
+  int values[15] = {};
+};
+
+// 'threads' readers access the configuration while one writer publishes a
+// new version every millisecond; reports reads per second (all readers)
+template <typename READ, typename WRITE>
+void track_reads(const std::string &name, unsigned threads, READ &&read,
+                 WRITE &&write) {
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::duration<double>;
+  const long N = 1'000'000;
+  std::atomic<bool> done{false};
+  std::thread writer([&done, &write] {
+    for (int version = 1; !done.load(); ++version) {
+      write(version);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  std::vector<std::thread> readers;
+  std::atomic<long> sum{0};
+  auto start = Clock::now();
+  for (unsigned t = 0; t < threads; ++t) {
+    readers.emplace_back([&sum, &read] {
+      long local = 0;
+      for (long i = 0; i < N; ++i)
+        local += read();
+      sum += local;
+    });
+  }
+  for (auto &&reader : readers)
+    reader.join();
+  auto stop = Clock::now();
+  done = true;
+  writer.join();
+  std::cout << name << " (" << threads << " readers): " << std::scientific
+            << N * threads / Duration(stop - start).count() << " reads/s"
+            << std::endl;
+}
+
+int main() {
+  const unsigned cores = std::max(2u, std::thread::hardware_concurrency());
+  for (unsigned threads : {1u, cores}) {
+    { // as in sptr_use.cpp: every access locks a weak_ptr
+      std::shared_ptr<const Config> owner = std::make_shared<Config>();
+      std::weak_ptr<const Config> wp = owner;
+      track_reads(
+          "weak_ptr::lock", threads,
+          [&wp] { return wp.lock()->version; },
+          [](int) {}); // the writer cannot swap 'owner' without a lock
+    }
+    {
+      std::atomic<std::shared_ptr<const Config>> config(
+          std::make_shared<Config>());
+      track_reads(
+          "atomic<shared_ptr>", threads,
+          [&config] { return config.load()->version; },
+          [&config](int version) {
+            auto next = std::make_shared<Config>();
+            next->version = version;
+            config.store(std::move(next));
+          });
+    }
+    {
+      rcu::snapshot<Config> config(std::make_unique<Config>());
+      track_reads(
+          "rcu::snapshot", threads,
+          [&config] { return config.read()->version; },
+          [&config](int version) {
+            config.update([version](Config &c) { c.version = version; });
+          });
+    }
+  }
+}
+
+// g++ -std=c++20 -O2 snapshot.cpp -pthread -o snapshot
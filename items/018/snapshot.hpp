@@ -0,0 +1,179 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// read-mostly data without reference counting (RCU / epoch based):
+// - readers announce the current epoch in their own cache line and read the
+//   published pointer; no shared counter is written
+// - a writer publishes a new immutable version and retires the old one; it
+//   is deleted after a grace period, i.e. once every reader that could still
+//   see it has finished
+// usage: rcu::snapshot<Config> config(std::make_unique<Config>());
+//        { auto view = config.read(); use(view->value); }
+//        config.publish(std::make_unique<Config>(...));
+namespace rcu {
+
+class Domain {
+public:
+  static constexpr std::size_t max_readers = 256; // reader threads at a time
+
+  static Domain &instance() {
+    static Domain *domain = new Domain; // never destroyed: thread exit
+    return *domain;
+  }
+
+  // outermost read section of this thread: announce the epoch
+  void enter() {
+    Reader &r = reader();
+    if (r.depth++ == 0) {
+      r.epoch.store(epoch.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+      // the announcement is visible before the pointer is loaded
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+  }
+  void leave() {
+    Reader &r = reader();
+    if (--r.depth == 0)
+      r.epoch.store(0, std::memory_order_release);
+  }
+
+  // 'ptr' was unpublished: delete it after the current grace period
+  template <typename T> void retire(const T *ptr) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::uint64_t e = epoch.fetch_add(1, std::memory_order_seq_cst);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto destroy = [](const void *p) { delete static_cast<const T *>(p); };
+      retired.push_back(Retired{ptr, destroy, e});
+    }
+    reclaim();
+  }
+  // deletes what no reader can see anymore, returns the number kept
+  std::size_t reclaim() {
+    const std::uint64_t oldest = oldest_reader();
+    std::vector<Retired> done;
+    std::size_t kept;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto keep = retired.begin();
+      for (auto &&item : retired) {
+        if (item.epoch < oldest)
+          done.push_back(item);
+        else
+          *keep++ = item;
+      }
+      retired.erase(keep, retired.end());
+      kept = retired.size();
+    }
+    for (auto &&item : done)
+      item.destroy(item.ptr);
+    return kept;
+  }
+  // blocks until everything retired so far is deleted
+  void synchronize() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    epoch.fetch_add(1, std::memory_order_seq_cst);
+    while (reclaim() != 0)
+      std::this_thread::yield();
+  }
+
+private:
+  struct alignas(64) Reader { // one cache line per reader thread
+    std::atomic<std::uint64_t> epoch{0}; // 0: not reading
+    std::atomic<bool> used{false};
+    unsigned depth = 0; // nesting, only accessed by the owner
+  };
+  struct Retired {
+    const void *ptr;
+    void (*destroy)(const void *);
+    std::uint64_t epoch; // last epoch in which readers could see 'ptr'
+  };
+  // releases the reader slot when the thread exits
+  struct Registration {
+    Reader *reader = nullptr;
+    ~Registration() {
+      if (reader)
+        reader->used.store(false, std::memory_order_release);
+    }
+  };
+
+  alignas(64) std::atomic<std::uint64_t> epoch{1};
+  Reader readers[max_readers];
+  std::mutex mutex;
+  std::vector<Retired> retired;
+
+  Reader &reader() {
+    thread_local Registration registration;
+    if (!registration.reader) {
+      for (std::size_t i = 0;; i = (i + 1) % max_readers) {
+        bool expected = false;
+        if (readers[i].used.compare_exchange_strong(expected, true)) {
+          registration.reader = &readers[i];
+          break;
+        }
+      }
+    }
+    return *registration.reader;
+  }
+  std::uint64_t oldest_reader() const {
+    std::uint64_t oldest = epoch.load(std::memory_order_seq_cst);
+    for (const Reader &r : readers) {
+      const std::uint64_t e = r.epoch.load(std::memory_order_acquire);
+      if (e != 0 && e < oldest)
+        oldest = e;
+    }
+    return oldest;
+  }
+};
+
+// RAII read section: the snapshot seen inside stays valid until its end
+template <typename T> class View {
+  const T *ptr;
+
+public:
+  explicit View(const std::atomic<const T *> &current) {
+    Domain::instance().enter();
+    ptr = current.load(std::memory_order_acquire);
+  }
+  View(const View &) = delete;
+  View &operator=(const View &) = delete;
+  ~View() { Domain::instance().leave(); }
+  const T &operator*() const { return *ptr; }
+  const T *operator->() const { return ptr; }
+  const T *get() const { return ptr; }
+};
+
+template <typename T> class snapshot {
+  std::atomic<const T *> current;
+
+public:
+  explicit snapshot(std::unique_ptr<const T> initial)
+      : current(initial.release()) {}
+  snapshot(const snapshot &) = delete;
+  snapshot &operator=(const snapshot &) = delete;
+  ~snapshot() { // no reader may be left
+    Domain::instance().synchronize();
+    delete current.load();
+  }
+
+  View<T> read() const { return View<T>(current); }
+
+  // readers see either the old or the new version, never a mix
+  void publish(std::unique_ptr<const T> next) {
+    const T *old = current.exchange(next.release());
+    Domain::instance().retire(old);
+  }
+  // copy, modify, publish (concurrent updates: serialize the writers)
+  template <typename FUNC> void update(FUNC &&func) {
+    auto next = std::make_unique<T>(*read());
+    func(*next);
+    publish(std::move(next));
+  }
+};
+
+} // namespace rcu
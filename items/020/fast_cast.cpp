@@ -0,0 +1,163 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// RTTI-free downcasting: each class of a hierarchy gets a pre-order number,
+// so all classes derived from T have ids in [first(T), last(T)] and
+// 'fast_cast<T>(base)' is a single range check on the id stored in the object
+
+// description of the hierarchy: Node<Class, Node<Child>...>
+template <typename T, typename... CHILDREN> struct Node {};
+
+template <typename NODE> struct SubtreeSize;
+template <typename T, typename... CHILDREN>
+struct SubtreeSize<Node<T, CHILDREN...>> {
+  static constexpr std::uint32_t value =
+      1 + (0 + ... + SubtreeSize<CHILDREN>::value);
+};
+
+struct IdRange {
+  std::uint32_t first = 1; // empty range: first > last
+  std::uint32_t last = 0;
+  constexpr bool valid() const { return first <= last; }
+};
+
+template <typename X, typename T, typename... CHILDREN>
+constexpr IdRange find_ids(Node<T, CHILDREN...>, std::uint32_t first) {
+  if constexpr (std::is_same_v<X, T>) {
+    return {first, first + SubtreeSize<Node<T, CHILDREN...>>::value - 1};
+  } else {
+    IdRange result{};
+    std::uint32_t next = first + 1;
+    ((result = result.valid() ? result : find_ids<X>(CHILDREN{}, next),
+      next += SubtreeSize<CHILDREN>::value),
+     ...);
+    return result;
+  }
+}
+
+// specialized for each root class: 'using type = Node<...>;'
+template <typename ROOT> struct Hierarchy;
+
+template <typename T, typename ROOT> constexpr IdRange type_ids() {
+  constexpr IdRange ids = find_ids<T>(typename Hierarchy<ROOT>::type{}, 0);
+  static_assert(ids.valid(), "class is not part of the hierarchy");
+  return ids;
+}
+
+// mixin for the root class: stores the id of the most derived class; the id
+// belongs to the object, so copies and assignments never transfer it
+template <typename ROOT> class FastCastRoot {
+  template <typename SELF, typename PARENT> friend struct FastCast;
+  template <typename T, typename B> friend T *fast_cast(B *ptr);
+  std::uint32_t type_id = type_ids<ROOT, ROOT>().first;
+
+public:
+  using fast_cast_root = ROOT;
+  FastCastRoot() = default;
+  FastCastRoot(const FastCastRoot &) {}
+  FastCastRoot &operator=(const FastCastRoot &) { return *this; }
+};
+
+// mixin for derived classes: struct Widget : FastCast<Widget, Base> {...};
+template <typename SELF, typename PARENT> struct FastCast : PARENT {
+  template <typename... ARGS>
+  FastCast(ARGS &&... args) : PARENT(std::forward<ARGS>(args)...) {
+    set_type_id();
+  }
+  FastCast(const FastCast &other) : PARENT(other) { set_type_id(); }
+  FastCast(FastCast &&other) : PARENT(std::move(other)) { set_type_id(); }
+  FastCast &operator=(const FastCast &) = default;
+  FastCast &operator=(FastCast &&) = default;
+
+private:
+  void set_type_id() { // the most derived constructor runs last
+    this->type_id = type_ids<SELF, typename PARENT::fast_cast_root>().first;
+  }
+};
+
+// same semantics as dynamic_cast<T *>: nullptr if 'ptr' is not a T
+template <typename T, typename B> T *fast_cast(B *ptr) {
+  constexpr IdRange ids = type_ids<T, typename B::fast_cast_root>();
+  if (ptr != nullptr && ptr->type_id - ids.first <= ids.last - ids.first) {
+    return static_cast<T *>(ptr); // unsigned wrap-around: one comparison
+  }
+  return nullptr;
+}
+
+struct Base;
+struct Widget;
+struct Widget2;
+struct Other;
+template <> struct Hierarchy<Base> {
+  using type = Node<Base, Node<Widget, Node<Widget2>>, Node<Other>>;
+};
+
+struct Base : FastCastRoot<Base> {
+  virtual int calculate() = 0; // pure virtual
+  virtual ~Base() = default;
+};
+struct Widget : FastCast<Widget, Base> {
+  int calculate() override { return 1; }
+};
+struct Widget2 : FastCast<Widget2, Widget> {
+  int calculate() override { return 2; }
+};
+struct Other : FastCast<Other, Base> {
+  int calculate() override { return 3; }
+};
+
+template <typename CALLABLE>
+void track_time(const std::string &name, CALLABLE &&func) {
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::duration<double>;
+  func(); // warmup
+  auto start = Clock::now();
+  func();
+  auto stop = Clock::now();
+  std::cout << name << ": " << std::scientific << Duration(stop - start).count()
+            << "s" << std::endl;
+}
+
+int main() {
+  {
+    Base *base = new Widget2{};          // upcasting
+    Widget *w = fast_cast<Widget>(base); // downcasting
+    Other *o = fast_cast<Other>(base);   // nullptr
+    std::cout << (w == dynamic_cast<Widget *>(base)) << " " << (o == nullptr)
+              << std::endl;
+    delete base;
+  }
+  {
+    std::vector<std::unique_ptr<Base>> vec;
+    std::mt19937 gen(0);
+    for (int i = 0; i < 1'000'000; ++i) {
+      switch (gen() % 3) {
+      case 0:
+        vec.emplace_back(new Widget{});
+        break;
+      case 1:
+        vec.emplace_back(new Widget2{});
+        break;
+      default:
+        vec.emplace_back(new Other{});
+      }
+    }
+    long count = 0;
+    track_time("dynamic_cast", [&] {
+      for (auto &&item : vec)
+        count += dynamic_cast<Widget *>(item.get()) != nullptr;
+    });
+    track_time("fast_cast", [&] {
+      for (auto &&item : vec)
+        count += fast_cast<Widget>(item.get()) != nullptr;
+    });
+    std::cout << count << std::endl;
+  }
+}
@@ -0,0 +1,109 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+struct Base {
+  virtual int calculate() { return 5; }
+  virtual ~Base() = default;
+};
+struct Widget1 : public Base {
+  int calculate() override { return 1; }
+};
+struct Widget2 : public Base {
+  int calculate() override { return 2; }
+};
+
+// one contiguous segment (std::vector) per concrete type TYPES...;
+// iteration visits segment by segment with the final type known
+template <typename BASE, typename... TYPES> class poly_collection {
+  static_assert((std::is_base_of_v<BASE, TYPES> && ...));
+  std::tuple<std::vector<TYPES>...> segments;
+
+public:
+  template <typename T> void insert(T &&value) {
+    using D = std::decay_t<T>;
+    static_assert((std::is_same_v<D, TYPES> || ...), "type not registered");
+    std::get<std::vector<D>>(segments).push_back(std::forward<T>(value));
+  }
+  template <typename T, typename... ARGS> T &emplace(ARGS &&... args) {
+    return std::get<std::vector<T>>(segments).emplace_back(
+        std::forward<ARGS>(args)...);
+  }
+  std::size_t size() const {
+    return std::apply([](auto &... seg) { return (seg.size() + ...); },
+                      segments);
+  }
+  template <typename T> std::vector<T> &segment() {
+    return std::get<std::vector<T>>(segments);
+  }
+  // 'func' is called with 'T &' for each element of each segment T;
+  // a qualified call 'item.T::calculate()' is not dispatched virtually
+  template <typename FUNC> void for_each(FUNC &&func) {
+    std::apply(
+        [&func](auto &... seg) {
+          (..., [&func](auto &s) {
+            for (auto &&item : s)
+              func(item);
+          }(seg));
+        },
+        segments);
+  }
+};
+
+template <typename CALLABLE>
+void track_time(const std::string &name, CALLABLE &&func) {
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::duration<double>;
+  func(); // warmup
+  auto start = Clock::now();
+  func();
+  auto stop = Clock::now();
+  std::cout << name << ": " << std::scientific << Duration(stop - start).count()
+            << "s" << std::endl;
+}
+
+int main() {
+  const int N = 1'000'000;
+  std::vector<std::unique_ptr<Base>> vec;
+  poly_collection<Base, Widget1, Widget2, Base> coll;
+  std::mt19937 gen(0);
+  for (int i = 0; i < N; ++i) { // random order of types
+    switch (gen() % 3) {
+    case 0:
+      vec.emplace_back(new Widget1{});
+      coll.insert(Widget1{});
+      break;
+    case 1:
+      vec.emplace_back(new Widget2{});
+      coll.insert(Widget2{});
+      break;
+    default:
+      vec.emplace_back(new Base{});
+      coll.insert(Base{});
+    }
+  }
+
+  long sum = 0;
+  track_time("vector<unique_ptr<Base>>", [&] {
+    for (auto &&item : vec) {
+      sum += item->calculate(); // pointer chase + indirect call
+    }
+  });
+  track_time("poly_collection (virtual)", [&] {
+    coll.for_each([&sum](Base &item) { sum += item.calculate(); });
+  });
+  track_time("poly_collection (final type)", [&] {
+    coll.for_each([&sum](auto &item) {
+      using T = std::decay_t<decltype(item)>;
+      sum += item.T::calculate(); // inlined
+    });
+  });
+  std::cout << sum << " " << coll.size() << std::endl;
+}
@@ -0,0 +1,113 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace virt { // open hierarchy: heap objects, vtables, dynamic_cast
+struct Base {
+  virtual int calculate() = 0; // pure virtual
+  virtual ~Base() = default;
+};
+struct Widget : public Base {
+  int calculate() override { return 1; }
+};
+struct Widget2 : public Widget {
+  int calculate() override { return 2; }
+  int extra() { return 3; }
+};
+} // namespace virt
+
+namespace closed { // closed set of types: values, no vtable pointer
+struct Widget {
+  int calculate() const { return 1; }
+};
+struct Widget2 {
+  int calculate() const { return 2; }
+  int extra() const { return 3; }
+};
+using Any = std::variant<Widget, Widget2>;
+} // namespace closed
+
+// visit via a jump table generated at compile time (one entry per type);
+// throws std::bad_variant_access like std::visit if 'v' holds no value
+template <typename FUNC, typename... TYPES>
+decltype(auto) visit_table(FUNC &&func, std::variant<TYPES...> &v) {
+  using R = std::invoke_result_t<FUNC, std::variant_alternative_t<
+                                           0, std::variant<TYPES...>> &>;
+  using Entry = R (*)(FUNC &, std::variant<TYPES...> &);
+  static constexpr Entry table[] = {
+      [](FUNC &f, std::variant<TYPES...> &v) -> R {
+        return f(*std::get_if<TYPES>(&v));
+      }...};
+  if (v.valueless_by_exception()) // index() is variant_npos
+    throw std::bad_variant_access();
+  return table[v.index()](func, v);
+}
+
+// batch visit: 'func' is called for each element of 'vec'
+template <typename FUNC, typename... TYPES>
+void visit_all(std::vector<std::variant<TYPES...>> &vec, FUNC &&func) {
+  for (auto &&item : vec) {
+    visit_table(func, item);
+  }
+}
+
+template <typename CALLABLE>
+void track_time(const std::string &name, CALLABLE &&func) {
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::duration<double>;
+  func(); // warmup
+  auto start = Clock::now();
+  func();
+  auto stop = Clock::now();
+  std::cout << name << ": " << std::scientific << Duration(stop - start).count()
+            << "s" << std::endl;
+}
+
+int main() {
+  const int N = 1'000'000;
+  std::vector<std::unique_ptr<virt::Base>> ptrs;
+  std::vector<closed::Any> values;
+  std::mt19937 gen(0);
+  for (int i = 0; i < N; ++i) {
+    if (gen() % 2) {
+      ptrs.emplace_back(new virt::Widget{});
+      values.emplace_back(closed::Widget{});
+    } else {
+      ptrs.emplace_back(new virt::Widget2{});
+      values.emplace_back(closed::Widget2{});
+    }
+  }
+
+  long sum = 0;
+  track_time("virtual calculate()", [&] {
+    for (auto &&item : ptrs) {
+      sum += item->calculate();
+    }
+  });
+  track_time("variant calculate()", [&] {
+    visit_all(values, [&sum](auto &item) { sum += item.calculate(); });
+  });
+  track_time("dynamic_cast<Widget2 *>", [&] {
+    for (auto &&item : ptrs) {
+      if (auto w2 = dynamic_cast<virt::Widget2 *>(item.get())) {
+        sum += w2->extra();
+      }
+    }
+  });
+  track_time("std::get_if<Widget2>", [&] {
+    for (auto &&item : values) {
+      if (auto w2 = std::get_if<closed::Widget2>(&item)) {
+        sum += w2->extra();
+      }
+    }
+  });
+  std::cout << sum << std::endl;
+}
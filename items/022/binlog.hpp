@@ -0,0 +1,216 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// asynchronous binary logger:
+// - 'log' copies a fixed-size record into a per-thread lock-free ring buffer
+// - a background thread formats the records and writes them to 'stdout'
+// usage: binlog::log("working on widget: {}", widget.m);
+namespace binlog {
+
+struct Arg {
+  enum class Kind : std::uint8_t { Int, Uint, Double, String } kind;
+  union {
+    std::int64_t i;
+    std::uint64_t u;
+    double d;
+    const char *s; // string literal (not copied)
+  };
+};
+
+// only char arrays are accepted as strings, not 'const char *': the pointer
+// is formatted later by the background thread, so it has to stay valid
+// (a string literal; never a local buffer)
+template <std::size_t N> Arg to_arg(const char (&value)[N]) {
+  Arg arg;
+  arg.kind = Arg::Kind::String;
+  arg.s = value;
+  return arg;
+}
+
+template <typename T> Arg to_arg(const T &value) {
+  static_assert(std::is_arithmetic_v<T>,
+                "only arithmetic types and string literals can be logged");
+  Arg arg;
+  if constexpr (std::is_floating_point_v<T>) {
+    arg.kind = Arg::Kind::Double;
+    arg.d = value;
+  } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    arg.kind = Arg::Kind::Int;
+    arg.i = value;
+  } else {
+    arg.kind = Arg::Kind::Uint;
+    arg.u = value;
+  }
+  return arg;
+}
+
+struct Record {
+  std::uint64_t time;  // ns since start of the logger
+  const char *format;  // string literal, each '{}' is replaced by an argument
+  std::uint32_t count; // number of arguments
+  Arg args[4];
+};
+
+// single-producer (logging thread) single-consumer (background thread)
+class Ring {
+public:
+  static constexpr std::size_t capacity = 1024;
+  explicit Ring(std::uint32_t id) : id(id) {}
+  bool push(const Record &record) { // never blocks: drops if full
+    const std::size_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == capacity) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    records[h % capacity] = record;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+  bool pop(Record &record) {
+    const std::size_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) {
+      return false;
+    }
+    record = records[t % capacity];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+  const std::uint32_t id;
+  std::atomic<std::size_t> dropped{0};
+
+private:
+  alignas(64) std::atomic<std::size_t> head{0}; // written by producer
+  alignas(64) std::atomic<std::size_t> tail{0}; // written by consumer
+  std::array<Record, capacity> records;
+};
+
+class Logger {
+public:
+  static Logger &instance() {
+    static Logger logger;
+    return logger;
+  }
+  template <typename... ARGS>
+  void log(const char *format, const ARGS &... args) {
+    static_assert(sizeof...(ARGS) <= 4, "at most 4 arguments");
+    Record record{now(), format, sizeof...(ARGS), {to_arg(args)...}};
+    ring().push(record);
+  }
+  void flush() { // formats all records logged before the call
+    std::lock_guard<std::mutex> lock(consumer);
+    drain();
+    std::fflush(out);
+  }
+  Logger(const Logger &) = delete;
+  Logger &operator=(const Logger &) = delete;
+  ~Logger() {
+    shutdown = true;
+    worker.join();
+    flush();
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+  Logger() : start(Clock::now()), worker([this] { run(); }) {}
+  std::uint64_t now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                                start)
+        .count();
+  }
+  Ring &ring() { // registered once per thread
+    thread_local std::shared_ptr<Ring> local = [this] {
+      std::lock_guard<std::mutex> lock(registry);
+      rings.push_back(std::make_shared<Ring>(rings.size()));
+      return rings.back();
+    }();
+    return *local;
+  }
+  void run() {
+    while (!shutdown) {
+      bool idle;
+      {
+        std::lock_guard<std::mutex> lock(consumer);
+        idle = !drain();
+      }
+      if (idle) {
+        std::fflush(out);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  }
+  bool drain() { // returns true if any record was written
+    std::vector<std::shared_ptr<Ring>> current;
+    {
+      std::lock_guard<std::mutex> lock(registry);
+      current = rings;
+    }
+    bool written = false;
+    Record record;
+    for (auto &&r : current) {
+      while (r->pop(record)) {
+        write(r->id, record);
+        written = true;
+      }
+      if (std::size_t n = r->dropped.exchange(0)) {
+        std::fprintf(out, "[binlog] thread %u dropped %zu records\n", r->id, n);
+      }
+    }
+    return written;
+  }
+  void write(std::uint32_t id, const Record &record) {
+    std::fprintf(out, "[%12.6f] %u: ", record.time * 1e-9, id);
+    const char *pos = record.format;
+    for (std::uint32_t i = 0; i < record.count; ++i) {
+      const char *next = std::strstr(pos, "{}");
+      if (next == nullptr) {
+        break;
+      }
+      std::fwrite(pos, 1, next - pos, out);
+      const Arg &arg = record.args[i];
+      switch (arg.kind) {
+      case Arg::Kind::Int:
+        std::fprintf(out, "%lld", static_cast<long long>(arg.i));
+        break;
+      case Arg::Kind::Uint:
+        std::fprintf(out, "%llu", static_cast<unsigned long long>(arg.u));
+        break;
+      case Arg::Kind::Double:
+        std::fprintf(out, "%g", arg.d);
+        break;
+      case Arg::Kind::String:
+        std::fputs(arg.s, out);
+        break;
+      }
+      pos = next + 2;
+    }
+    std::fputs(pos, out);
+    std::fputc('\n', out);
+  }
+
+  std::FILE *out = stdout;
+  const Clock::time_point start;
+  std::mutex registry; // guards 'rings'
+  std::mutex consumer; // only one thread drains at a time
+  std::vector<std::shared_ptr<Ring>> rings;
+  std::atomic<bool> shutdown{false};
+  std::thread worker; // last member: started after all others are ready
+};
+
+template <typename... ARGS>
+void log(const char *format, const ARGS &... args) {
+  Logger::instance().log(format, args...);
+}
+
+inline void flush() { Logger::instance().flush(); }
+
+} // namespace binlog
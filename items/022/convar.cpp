@@ -1,3 +1,5 @@
+#include "binlog.hpp"
+#include "trace.hpp"
 #include <condition_variable>
 #include <future>
 #include <iostream>
@@ -25,27 +27,36 @@ int main() {
   }
 
   auto base_task = [&work_items, &shutdown]() {
+    trace::set_thread_name("worker");
     while (true) {
       Widget current;
 
-      std::unique_lock<std::mutex> l(m); // get lock 
+      std::unique_lock<std::mutex> l(m, std::defer_lock);
+      {
+        trace::Zone zone("acquire lock"); // lock wait on the timeline
+        l.lock(); // get lock
+      }
 
-      v.wait(l, [&work_items,
-                 &shutdown] { // release lock already and wait with predicate:
-                              // all threads "sit here and idle"
-        return !work_items.empty() ||
-               shutdown; // wakeup when work to do or shutdown signal
-      });
+      {
+        trace::Zone zone("wait for work"); // idle time on the timeline
+        v.wait(l, [&work_items,
+                   &shutdown] { // release lock already and wait with
+                                // predicate: all threads "sit here and idle"
+          return !work_items.empty() ||
+                 shutdown; // wakeup when work to do or shutdown signal
+        });
+      }
 
       if (!shutdown) { // -> do seme work
+        trace::Zone zone("work");
         current = std::move(work_items.front());
         work_items.pop_front();
-        std::cout << "working on widget: "<< current.m  << std::endl;
+        binlog::log("working on widget: {}", current.m); // no syscall/lock
         // perform work on current Widget here
       }
 
       if (shutdown) {
-        std::cout << "shutdown signal" << std::endl;
+        binlog::log("shutdown signal");
         return; // end thread
       }
 
@@ -66,4 +77,8 @@ int main() {
   // shutdown
   shutdown = true;
   v.notify_all();
+  for (auto &&handle : handles) {
+    handle.wait();
+  }
+  trace::dump("convar.trace.json"); // open in https://ui.perfetto.dev
 }
\ No newline at end of file
@@ -32,7 +32,7 @@ int main() {
     std::vector<double> shared_data2;
     auto manip = [&m1, &m2, &shared_data1, &shared_data2]() {
       std::unique_lock<std::mutex> dlock1(m1, std::defer_lock);
-      std::unique_lock<std::mutex> dlock2(m1, std::defer_lock);
+      std::unique_lock<std::mutex> dlock2(m2, std::defer_lock);
       std::lock(dlock1, dlock2); 
       // manipulate shared_data1 and shared_data2 together
     };
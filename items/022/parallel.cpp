@@ -0,0 +1,87 @@
+#include "parallel.hpp"
+#include <cmath>
+#include <future>
+#include <iostream>
+#include <string>
+#include <vector>
+
+template <typename CALLABLE>
+void track_time(const std::string &name, CALLABLE &&func) {
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::duration<double>;
+  func(); // warmup
+  auto start = Clock::now();
+  func();
+  auto stop = Clock::now();
+  std::cout << name << ": " << std::scientific << Duration(stop - start).count()
+            << "s" << std::endl;
+}
+
+// irregular cost: iteration i does work proportional to i
+double work(std::size_t i) {
+  double value = 0;
+  for (std::size_t k = 0; k < i / 64; ++k) {
+    value += std::sqrt(double(k + i));
+  }
+  return value;
+}
+
+int main() {
+  using parallel::Range;
+  using parallel::Schedule;
+  const std::size_t N = 100'000;
+  std::vector<double> out(N);
+  std::cout << parallel::Pool::instance().size() << " threads" << std::endl;
+
+  track_time("serial", [&] {
+    for (std::size_t i = 0; i < N; ++i)
+      out[i] = work(i);
+  });
+  track_time("std::async (equal blocks)", [&] {
+    const unsigned threads = parallel::Pool::instance().size();
+    std::vector<std::future<void>> futures;
+    for (unsigned t = 0; t < threads; ++t) {
+      futures.push_back(std::async(std::launch::async, [&, t] {
+        for (std::size_t i = N * t / threads; i < N * (t + 1) / threads; ++i)
+          out[i] = work(i);
+      }));
+    }
+  });
+  auto body = [&out](Range r) {
+    for (auto i : r)
+      out[i] = work(i);
+  };
+  track_time("parallel_for static", [&] {
+    parallel::parallel_for(Range(0, N), body, {Schedule::Kind::Static});
+  });
+  track_time("parallel_for static (grain 64)", [&] {
+    parallel::parallel_for(Range(0, N), body, {Schedule::Kind::Static, 64});
+  });
+  track_time("parallel_for dynamic (grain 1)", [&] {
+    parallel::parallel_for(Range(0, N), body, {Schedule::Kind::Dynamic, 1});
+  });
+  track_time("parallel_for dynamic (auto)", [&] {
+    parallel::parallel_for(Range(0, N), body, {Schedule::Kind::Dynamic});
+  });
+  track_time("parallel_for guided (auto)", [&] {
+    parallel::parallel_for(Range(0, N), body, {Schedule::Kind::Guided});
+  });
+
+  double sum = 0;
+  track_time("parallel_reduce guided", [&] {
+    sum = parallel::parallel_reduce(
+        Range(0, N), 0.0,
+        [](Range r, double acc) {
+          for (auto i : r)
+            acc += work(i);
+          return acc;
+        },
+        [](double a, double b) { return a + b; }, {Schedule::Kind::Guided});
+  });
+  double expected = 0;
+  for (auto &&value : out)
+    expected += value;
+  std::cout << sum << " " << expected << std::endl;
+}
+
+// g++ -std=c++17 -O2 parallel.cpp -pthread -o parallel
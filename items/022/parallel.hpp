@@ -0,0 +1,286 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// loop parallelism without OpenMP/TBB (cf. '#pragma omp for schedule(...)'
+// and 'tbb::parallel_for'): the iterations of a Range are distributed in
+// chunks to the threads of a persistent Pool
+// usage: parallel::parallel_for(Range(0, n), [&](Range r) {
+//          for (auto i : r) ...
+//        }, {parallel::Schedule::Kind::Guided});
+namespace parallel {
+
+// half-open range of indices [first, last), iterable
+struct Range {
+  std::size_t first = 0;
+  std::size_t last = 0;
+  Range() = default;
+  Range(std::size_t first, std::size_t last) : first(first), last(last) {}
+  std::size_t size() const { return last - first; }
+  bool empty() const { return first == last; }
+
+  struct Iterator {
+    std::size_t i;
+    std::size_t operator*() const { return i; }
+    Iterator &operator++() {
+      ++i;
+      return *this;
+    }
+    bool operator!=(const Iterator &other) const { return i != other.i; }
+  };
+  Iterator begin() const { return {first}; }
+  Iterator end() const { return {last}; }
+};
+
+struct Schedule {
+  enum class Kind {
+    Static,  // equal contiguous blocks (grain > 0: round-robin chunks)
+    Dynamic, // chunks of 'grain' taken from a shared counter
+    Guided   // chunks shrink with the remaining work, at least 'grain'
+  } kind = Kind::Static;
+  std::size_t grain = 0; // 0: auto-tuned from the measured chunk duration
+};
+
+// fork-join pool: 'run' executes a job on all workers and the caller
+class Pool {
+public:
+  explicit Pool(unsigned threads = std::thread::hardware_concurrency()) {
+    for (unsigned id = 1; id < std::max(threads, 1u); ++id) {
+      workers.emplace_back(&Pool::work, this, id);
+    }
+  }
+  Pool(const Pool &) = delete;
+  Pool &operator=(const Pool &) = delete;
+  ~Pool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    wake.notify_all();
+    for (auto &&worker : workers)
+      worker.join();
+  }
+  static Pool &instance() {
+    static Pool pool;
+    return pool;
+  }
+  // number of participants (workers + calling thread)
+  unsigned size() const { return workers.size() + 1; }
+
+  // func(id) is called once for each id in [0, size()); blocks until done;
+  // nested calls (from inside a job) run serially on the calling thread
+  template <typename FUNC> void run(FUNC &&func) {
+    if (inside_job() || workers.empty()) {
+      for (unsigned id = 0; id < size(); ++id)
+        func(id);
+      return;
+    }
+    std::lock_guard<std::mutex> one_job(submit); // one job at a time
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      // FUNC may be a (const) lvalue reference: cast via the object type
+      using Object = std::remove_reference_t<FUNC>;
+      job = Job{const_cast<void *>(
+                    static_cast<const void *>(std::addressof(func))),
+                [](void *f, unsigned id) { (*static_cast<Object *>(f))(id); }};
+      pending = workers.size();
+      ++generation;
+    }
+    wake.notify_all();
+    inside_job() = true;
+    func(0);
+    inside_job() = false;
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return pending == 0; });
+  }
+
+private:
+  struct Job {
+    void *func = nullptr;
+    void (*invoke)(void *, unsigned) = nullptr; // no allocation per job
+  };
+  std::vector<std::thread> workers;
+  std::mutex submit;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable finished;
+  Job job;
+  std::size_t generation = 0;
+  std::size_t pending = 0;
+  bool stop = false;
+
+  static bool &inside_job() {
+    thread_local bool inside = false;
+    return inside;
+  }
+  void work(unsigned id) {
+    inside_job() = true;
+    std::size_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      wake.wait(lock, [this, seen] { return stop || generation != seen; });
+      if (stop)
+        return;
+      seen = generation;
+      const Job current = job;
+      lock.unlock();
+      current.invoke(current.func, id);
+      lock.lock();
+      if (--pending == 0)
+        finished.notify_one();
+    }
+  }
+};
+
+// hands out chunks of a range according to a schedule (shared by all threads)
+class Chunker {
+public:
+  Chunker(Range range, Schedule schedule, unsigned threads)
+      : range(range), schedule(schedule), threads(threads),
+        next(range.first) {}
+
+  // per-thread state: position for static, tuned grain for auto
+  struct Local {
+    unsigned id;
+    std::size_t round = 0;
+    std::size_t grain;
+  };
+  Local local(unsigned id) const {
+    const std::size_t initial =
+        std::max<std::size_t>(1, range.size() / (std::size_t(threads) * 64));
+    return Local{id, 0, schedule.grain ? schedule.grain : initial};
+  }
+
+  // the next chunk for this thread, empty if there is no work left
+  Range take(Local &l) {
+    const std::size_t n = range.size();
+    switch (schedule.kind) {
+    case Schedule::Kind::Static:
+      if (schedule.grain == 0) { // one block per thread
+        if (l.round++ > 0)
+          return Range();
+        return Range(range.first + n * l.id / threads,
+                     range.first + n * (l.id + 1) / threads);
+      } else {
+        const std::size_t first =
+            range.first + (l.round++ * threads + l.id) * schedule.grain;
+        return first < range.last
+                   ? Range(first, std::min(first + schedule.grain, range.last))
+                   : Range();
+      }
+    case Schedule::Kind::Dynamic: {
+      const std::size_t first = next.fetch_add(l.grain);
+      return first < range.last
+                 ? Range(first, std::min(first + l.grain, range.last))
+                 : Range();
+    }
+    case Schedule::Kind::Guided:
+    default: {
+      std::size_t first = next.load();
+      std::size_t size;
+      do {
+        if (first >= range.last)
+          return Range();
+        const std::size_t remaining = range.last - first;
+        size = std::min(remaining,
+                        std::max(l.grain, remaining / (2 * threads)));
+      } while (!next.compare_exchange_weak(first, first + size));
+      return Range(first, first + size);
+    }
+    }
+  }
+
+  // auto grain: aim at chunks of about 'target' duration, long enough to
+  // amortize the atomic counter and short enough to balance the load
+  void tune(Local &l, Range chunk, std::chrono::nanoseconds elapsed) const {
+    using namespace std::chrono_literals;
+    constexpr auto target = std::chrono::nanoseconds(50us);
+    const double scale =
+        double(target.count()) / std::max<long long>(elapsed.count(), 1);
+    const double grain = chunk.size() * std::clamp(scale, 0.5, 2.0);
+    const std::size_t limit =
+        std::max<std::size_t>(1, range.size() / (std::size_t(threads) * 4));
+    l.grain = std::clamp<std::size_t>(std::size_t(grain), 1, limit);
+  }
+  bool tuning() const { // 'tune' is only used if this is true
+    return schedule.grain == 0 && schedule.kind != Schedule::Kind::Static;
+  }
+
+private:
+  Range range;
+  Schedule schedule;
+  unsigned threads;
+  alignas(64) std::atomic<std::size_t> next;
+};
+
+// participant 'id' processes chunks until the range is exhausted;
+// the first exception stops all participants and is rethrown by the caller
+template <typename FUNC>
+void for_each_chunk(Range range, Schedule schedule, Pool &pool, FUNC &&func) {
+  if (range.empty())
+    return;
+  Chunker chunker(range, schedule, pool.size());
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  pool.run([&](unsigned id) {
+    auto local = chunker.local(id);
+    try {
+      for (Range chunk = chunker.take(local); !chunk.empty();
+           chunk = chunker.take(local)) {
+        if (failed.load(std::memory_order_relaxed))
+          return;
+        if (chunker.tuning()) {
+          const auto start = std::chrono::steady_clock::now();
+          func(id, chunk);
+          chunker.tune(local, chunk, std::chrono::steady_clock::now() - start);
+        } else {
+          func(id, chunk);
+        }
+      }
+    } catch (...) {
+      if (!failed.exchange(true))
+        error = std::current_exception();
+    }
+  });
+  if (error)
+    std::rethrow_exception(error);
+}
+
+// body(Range) is called for disjoint chunks covering 'range'
+template <typename BODY>
+void parallel_for(Range range, BODY &&body, Schedule schedule = {},
+                  Pool &pool = Pool::instance()) {
+  for_each_chunk(range, schedule, pool,
+                 [&body](unsigned, Range chunk) { body(chunk); });
+}
+
+// body(Range, T) -> T accumulates a chunk, combine(T, T) -> T joins the
+// per-thread results (in thread order; chunk order only for Static)
+template <typename T, typename BODY, typename COMBINE>
+T parallel_reduce(Range range, T identity, BODY &&body, COMBINE &&combine,
+                  Schedule schedule = {}, Pool &pool = Pool::instance()) {
+  struct alignas(64) Partial { // no false sharing between threads
+    T value;
+  };
+  std::vector<Partial> partials(pool.size(), Partial{identity});
+  for_each_chunk(range, schedule, pool, [&](unsigned id, Range chunk) {
+    partials[id].value = body(chunk, std::move(partials[id].value));
+  });
+  T result = std::move(identity);
+  for (auto &&partial : partials) {
+    result = combine(std::move(result), std::move(partial.value));
+  }
+  return result;
+}
+
+} // namespace parallel
@@ -1,4 +1,5 @@
 
+#include "trace.hpp"
 #include <atomic>
 #include <chrono>
 #include <iostream>
@@ -13,8 +14,11 @@ auto track_time(const std::string &name, int iter, CALLABLE &&func,
   using TimePoint = std::chrono::time_point<std::chrono::steady_clock>;
   func(std::forward<ARGS>(args)...); // warmup
   TimePoint start = Clock::now();
-  for (int i = 0; i < iter; ++i)
+  const char *zone_name = trace::intern(name);
+  for (int i = 0; i < iter; ++i) {
+    trace::Zone zone(zone_name); // each iteration on the timeline
     func(std::forward<ARGS>(args)...);
+  }
   TimePoint stop = Clock::now();
   auto timespan = Duration(stop - start).count() / (iter - 1);
   std::cout << name << ": " << std::scientific << timespan << "s" << std::endl;
@@ -59,4 +63,5 @@ int main() {
     track_time("lock", 3, accumulate);
     std::cout << sum << std::endl;
   }
+  trace::dump("serial_atomic_vs_lock.trace.json");
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "striped.hpp"
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 'threads' threads call op(random key) 'N' times each; reports total ops/s
+template <typename OP>
+void track_ops(const std::string &name, unsigned threads, OP &&op) {
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::duration<double>;
+  const int N = 200'000;
+  const std::size_t K = 100'000; // independent keys
+  auto start = Clock::now();
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&op, t] {
+      std::minstd_rand gen(t);
+      for (int i = 0; i < N; ++i)
+        op(gen() % K, gen() % K);
+    });
+  }
+  for (auto &&worker : workers)
+    worker.join();
+  auto stop = Clock::now();
+  std::cout << name << " (" << threads << " threads): " << std::scientific
+            << N * threads / Duration(stop - start).count() << " ops/s"
+            << std::endl;
+}
+
+int main() {
+  const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<unsigned> counts;
+  for (unsigned threads = 1; threads < cores; threads *= 2)
+    counts.push_back(threads);
+  counts.push_back(cores);
+
+  for (unsigned threads : counts) {
+    { // one mutex for the whole map
+      std::mutex m;
+      std::unordered_map<std::size_t, long> map;
+      track_ops("unordered_map + mutex", threads,
+                [&m, &map](std::size_t key, std::size_t) {
+                  std::lock_guard<std::mutex> lock(m);
+                  ++map[key];
+                });
+    }
+    {
+      striped::ShardedMap<std::size_t, long> map;
+      track_ops("ShardedMap", threads, [&map](std::size_t key, std::size_t) {
+        map.update(key, [](long &value) { ++value; });
+      });
+    }
+    { // transfer between two entries: both shards locked
+      striped::ShardedMap<std::size_t, long> map;
+      track_ops("ShardedMap (pairs)", threads,
+                [&map](std::size_t from, std::size_t to) {
+                  map.update(from, to, [](long &a, long &b) {
+                    --a;
+                    ++b;
+                  });
+                });
+      long sum = 0;
+      map.for_each([&sum](std::size_t, long value) { sum += value; });
+      std::cout << "  sum = " << sum << std::endl; // always 0
+    }
+    {
+      std::mutex m;
+      std::vector<long> vec(100'000);
+      track_ops("vector + mutex", threads,
+                [&m, &vec](std::size_t i, std::size_t) {
+                  std::lock_guard<std::mutex> lock(m);
+                  ++vec[i];
+                });
+    }
+    {
+      striped::ShardedVector<long> vec(100'000, 256);
+      track_ops("ShardedVector", threads, [&vec](std::size_t i, std::size_t) {
+        vec.update(i, [](long &value) { ++value; });
+      });
+    }
+  }
+}
+
+// g++ -std=c++17 -O2 striped.cpp -pthread -o striped
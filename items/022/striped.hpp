@@ -0,0 +1,159 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// lock striping: the data is split into shards with one mutex each, so
+// threads working on different keys/indices rarely wait for each other;
+// operations on two elements lock both shards with 'std::scoped_lock'
+// (deadlock free, cf. the double mutex lock in mutex.cpp)
+namespace striped {
+
+constexpr std::size_t cache_line = 64;
+
+// hash -> shard, independent of the low bits used by unordered_map buckets
+inline std::size_t shard_of(std::size_t hash, unsigned bits) {
+  return bits == 0 ? 0
+                   : std::size_t(std::uint64_t(hash) * 0x9E3779B97F4A7C15ULL >>
+                                 (64 - bits));
+}
+
+template <typename KEY, typename VALUE, typename HASH = std::hash<KEY>>
+class ShardedMap {
+  struct alignas(cache_line) Shard { // no false sharing between locks
+    std::mutex mutex;
+    std::unordered_map<KEY, VALUE, HASH> map;
+  };
+  unsigned bits;
+  std::unique_ptr<Shard[]> shards;
+  HASH hash;
+
+  Shard &shard(const KEY &key) { return shards[shard_of(hash(key), bits)]; }
+
+public:
+  // 2^bits shards, a few per core are enough
+  explicit ShardedMap(unsigned bits = 6)
+      : bits(bits), shards(new Shard[std::size_t{1} << bits]) {}
+  std::size_t shard_count() const { return std::size_t{1} << bits; }
+
+  void insert_or_assign(const KEY &key, VALUE value) {
+    Shard &s = shard(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.map.insert_or_assign(key, std::move(value));
+  }
+  std::optional<VALUE> get(const KEY &key) {
+    Shard &s = shard(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto it = s.map.find(key);
+    return it == s.map.end() ? std::nullopt : std::optional<VALUE>(it->second);
+  }
+  bool erase(const KEY &key) {
+    Shard &s = shard(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.map.erase(key) != 0;
+  }
+  // func(VALUE &) under the shard lock, value-initialized if missing
+  template <typename FUNC> void update(const KEY &key, FUNC &&func) {
+    Shard &s = shard(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    func(s.map[key]);
+  }
+  // func(VALUE &, VALUE &) with both shards locked (one if they coincide)
+  template <typename FUNC>
+  void update(const KEY &key1, const KEY &key2, FUNC &&func) {
+    Shard &s1 = shard(key1);
+    Shard &s2 = shard(key2);
+    if (&s1 == &s2) {
+      std::lock_guard<std::mutex> lock(s1.mutex);
+      func(s1.map[key1], s1.map[key2]);
+    } else {
+      std::scoped_lock lock(s1.mutex, s2.mutex);
+      func(s1.map[key1], s2.map[key2]);
+    }
+  }
+  // shard by shard: not a consistent snapshot of the whole map
+  template <typename FUNC> void for_each(FUNC &&func) {
+    for (std::size_t i = 0; i < shard_count(); ++i) {
+      std::lock_guard<std::mutex> lock(shards[i].mutex);
+      for (auto &&[key, value] : shards[i].map)
+        func(key, value);
+    }
+  }
+  std::size_t size() {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < shard_count(); ++i) {
+      std::lock_guard<std::mutex> lock(shards[i].mutex);
+      n += shards[i].map.size();
+    }
+    return n;
+  }
+};
+
+// fixed number of elements in contiguous buckets, one lock per bucket
+template <typename T> class ShardedVector {
+  struct alignas(cache_line) Bucket {
+    std::mutex mutex;
+    std::vector<T> data;
+  };
+  std::size_t count;
+  std::size_t bucket_size;
+  std::vector<Bucket> buckets;
+
+  Bucket &bucket(std::size_t i) { return buckets[i / bucket_size]; }
+
+public:
+  ShardedVector(std::size_t count, std::size_t bucket_count,
+                const T &value = T())
+      : count(count),
+        bucket_size(std::max<std::size_t>(1, (count + bucket_count - 1) /
+                                                 bucket_count)),
+        buckets((count + bucket_size - 1) / bucket_size) {
+    for (std::size_t b = 0; b < buckets.size(); ++b) {
+      buckets[b].data.assign(std::min(bucket_size, count - b * bucket_size),
+                             value);
+    }
+  }
+  std::size_t size() const { return count; }
+
+  T get(std::size_t i) {
+    Bucket &b = bucket(i);
+    std::lock_guard<std::mutex> lock(b.mutex);
+    return b.data[i % bucket_size];
+  }
+  // func(T &) under the bucket lock
+  template <typename FUNC> void update(std::size_t i, FUNC &&func) {
+    Bucket &b = bucket(i);
+    std::lock_guard<std::mutex> lock(b.mutex);
+    func(b.data[i % bucket_size]);
+  }
+  // func(T &, T &) with both buckets locked (one if they coincide)
+  template <typename FUNC>
+  void update(std::size_t i, std::size_t j, FUNC &&func) {
+    Bucket &b1 = bucket(i);
+    Bucket &b2 = bucket(j);
+    if (&b1 == &b2) {
+      std::lock_guard<std::mutex> lock(b1.mutex);
+      func(b1.data[i % bucket_size], b1.data[j % bucket_size]);
+    } else {
+      std::scoped_lock lock(b1.mutex, b2.mutex);
+      func(b1.data[i % bucket_size], b2.data[j % bucket_size]);
+    }
+  }
+  // bucket by bucket: func(index, T &)
+  template <typename FUNC> void for_each(FUNC &&func) {
+    for (std::size_t b = 0; b < buckets.size(); ++b) {
+      std::lock_guard<std::mutex> lock(buckets[b].mutex);
+      for (std::size_t k = 0; k < buckets[b].data.size(); ++k)
+        func(b * bucket_size + k, buckets[b].data[k]);
+    }
+  }
+};
+
+} // namespace striped
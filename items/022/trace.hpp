@@ -0,0 +1,208 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// timeline profiler:
+// - 'Zone' records begin/end timestamps of a scope into a per-thread buffer
+//   (no lock, no allocation except for every 4096th event)
+// - 'dump' writes all events as Chrome Trace Event JSON, which can be opened
+//   in chrome://tracing or https://ui.perfetto.dev
+// usage: { trace::Zone zone("wait for work"); v.wait(l, ...); }
+//        trace::dump("convar.trace.json");
+namespace trace {
+
+struct Event {
+  std::uint64_t begin; // ns since start of the tracer
+  std::uint64_t end;   // == begin: instant event
+  const char *name;    // string literal or 'intern'ed
+};
+
+// written only by its thread, read by 'dump' at any time
+class Buffer {
+public:
+  static constexpr std::size_t chunk_size = 4096;
+  static constexpr std::size_t max_chunks = 1024; // then events are dropped
+  explicit Buffer(std::uint32_t id) : id(id) {}
+
+  void push(const Event &event) {
+    if (pos == chunk_size && !grow()) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    current->events[pos++] = event;
+    current->count.store(pos, std::memory_order_release);
+  }
+  template <typename FUNC> void for_each(FUNC &&func) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &&chunk : chunks) {
+      const std::size_t n = chunk->count.load(std::memory_order_acquire);
+      for (std::size_t i = 0; i < n; ++i)
+        func(chunk->events[i]);
+    }
+  }
+
+  const std::uint32_t id;
+  std::string name; // set by its thread before 'dump'
+  std::atomic<std::size_t> dropped{0};
+
+private:
+  struct Chunk {
+    std::array<Event, chunk_size> events;
+    std::atomic<std::size_t> count{0};
+  };
+  std::mutex mutex; // guards 'chunks' (not the events)
+  std::vector<std::unique_ptr<Chunk>> chunks;
+  Chunk *current = nullptr;
+  std::size_t pos = chunk_size;
+
+  bool grow() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (chunks.size() == max_chunks)
+      return false;
+    chunks.push_back(std::make_unique<Chunk>());
+    current = chunks.back().get();
+    pos = 0;
+    return true;
+  }
+};
+
+class Tracer {
+public:
+  static Tracer &instance() {
+    static Tracer tracer;
+    return tracer;
+  }
+  std::uint64_t now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                                start)
+        .count();
+  }
+  Buffer &buffer() { // registered once per thread
+    thread_local std::shared_ptr<Buffer> local = [this] {
+      std::lock_guard<std::mutex> lock(registry);
+      buffers.push_back(std::make_shared<Buffer>(buffers.size()));
+      return buffers.back();
+    }();
+    return *local;
+  }
+  // stable copy of a dynamic name (e.g. std::string), stored once
+  const char *intern(const std::string &name) {
+    std::lock_guard<std::mutex> lock(registry);
+    return names.insert(name).first->c_str();
+  }
+
+  // events recorded so far (threads may still be running)
+  bool dump(const char *filename) {
+    std::FILE *out = std::fopen(filename, "w");
+    if (!out)
+      return false;
+    std::vector<std::shared_ptr<Buffer>> current;
+    {
+      std::lock_guard<std::mutex> lock(registry);
+      current = buffers;
+    }
+    std::fputs("{\"traceEvents\":[\n", out);
+    const char *separator = "";
+    for (auto &&b : current) {
+      if (!b->name.empty()) {
+        std::fprintf(out,
+                     "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,"
+                     "\"tid\":%u,\"args\":{\"name\":",
+                     separator, b->id);
+        write_string(out, b->name.c_str());
+        std::fputs("}}", out);
+        separator = ",\n";
+      }
+      b->for_each([&](const Event &e) {
+        std::fprintf(out, "%s{\"ph\":\"%s\",\"pid\":1,\"tid\":%u,",
+                     separator, e.end == e.begin ? "i" : "X", b->id);
+        std::fprintf(out, "\"ts\":%.3f,", e.begin * 1e-3);
+        if (e.end != e.begin)
+          std::fprintf(out, "\"dur\":%.3f,", (e.end - e.begin) * 1e-3);
+        std::fputs("\"name\":", out);
+        write_string(out, e.name);
+        std::fputc('}', out);
+        separator = ",\n";
+      });
+      if (std::size_t n = b->dropped.load()) {
+        std::fprintf(stderr, "[trace] thread %u dropped %zu events\n", b->id,
+                     n);
+      }
+    }
+    std::fputs("\n],\"displayTimeUnit\":\"ns\"}\n", out);
+    return std::fclose(out) == 0;
+  }
+
+  Tracer(const Tracer &) = delete;
+  Tracer &operator=(const Tracer &) = delete;
+
+private:
+  using Clock = std::chrono::steady_clock;
+  Tracer() : start(Clock::now()) {}
+
+  static void write_string(std::FILE *out, const char *str) { // JSON escaped
+    std::fputc('"', out);
+    for (; *str; ++str) {
+      if (*str == '"' || *str == '\\')
+        std::fputc('\\', out);
+      if (static_cast<unsigned char>(*str) < 0x20)
+        std::fprintf(out, "\\u%04x", *str);
+      else
+        std::fputc(*str, out);
+    }
+    std::fputc('"', out);
+  }
+
+  const Clock::time_point start;
+  std::mutex registry; // guards 'buffers' and 'names'
+  std::vector<std::shared_ptr<Buffer>> buffers;
+  std::unordered_set<std::string> names;
+};
+
+// records the lifetime of the object as one event of this thread
+class Zone {
+public:
+  explicit Zone(const char *name)
+      : buffer(Tracer::instance().buffer()), name(name),
+        begin(Tracer::instance().now()) {}
+  Zone(const Zone &) = delete;
+  Zone &operator=(const Zone &) = delete;
+  ~Zone() {
+    std::uint64_t end = Tracer::instance().now();
+    buffer.push(Event{begin, end == begin ? end + 1 : end, name});
+  }
+
+private:
+  Buffer &buffer;
+  const char *name;
+  std::uint64_t begin;
+};
+
+// point in time, e.g. a notification
+inline void instant(const char *name) {
+  const std::uint64_t t = Tracer::instance().now();
+  Tracer::instance().buffer().push(Event{t, t, name});
+}
+
+// shown instead of the thread number; call before 'dump'
+inline void set_thread_name(const std::string &name) {
+  Tracer::instance().buffer().name = name;
+}
+
+inline const char *intern(const std::string &name) {
+  return Tracer::instance().intern(name);
+}
+
+inline bool dump(const char *filename) {
+  return Tracer::instance().dump(filename);
+}
+
+} // namespace trace
@@ -1,20 +1,28 @@
 #pragma once
-#include <iostream>
+#ifdef DEBUGGING
+#include "binlog.hpp" // asynchronous logger of item 022
+#endif
 
 namespace widget::internal { 
 
 template <typename T> struct Helper {
-  T *data;
-  Helper() : data(new T()) {}
-  ~Helper() { delete data; }
+  T data{}; // held by value: no allocation
   Helper &operator++() {
-    ++(*data);
+    ++data;
+#ifdef DEBUGGING
+    binlog::log("Debugging:{}", data);
+#endif
+
+    return *this;
+  }
+  Helper &operator+=(T n) {
+    data += n;
 #ifdef DEBUGGING
-    std::cout << "Debugging:" << *data << std::endl;
+    binlog::log("Debugging:{}", data);
 #endif
 
     return *this;
   }
 };
 
-} // namespace widget::internal
\ No newline at end of file
+} // namespace widget::internal
@@ -1,5 +1,7 @@
 #include "widget.hpp"
 #include "template.hpp"
+#include <new>
+#include <utility>
 
 namespace widget {
 
@@ -9,10 +11,52 @@ namespace widget {
     Helper<int> m;
   };
 
-  Widget::Widget() : ptr(std::make_shared<Widget::impl>()) {}
+  static_assert(sizeof(Widget::impl) <= Widget::impl_size,
+                "increase Widget::impl_size");
+  static_assert(alignof(Widget::impl) <= Widget::impl_align,
+                "increase Widget::impl_align");
+
+  Widget::impl &Widget::get() {
+    return *std::launder(reinterpret_cast<impl *>(storage));
+  }
+  const Widget::impl &Widget::get() const {
+    return *std::launder(reinterpret_cast<const impl *>(storage));
+  }
+
+  Widget::Widget() { new (storage) impl(); }
+  Widget::Widget(const Widget &other) { new (storage) impl(other.get()); }
+  Widget::Widget(Widget &&other) noexcept {
+    new (storage) impl(std::move(other.get()));
+  }
+  Widget &Widget::operator=(const Widget &other) {
+    get() = other.get();
+    return *this;
+  }
+  Widget &Widget::operator=(Widget &&other) noexcept {
+    get() = std::move(other.get());
+    return *this;
+  }
+  Widget::~Widget() { get().~impl(); }
+
   Widget &Widget::operator++() {
-    ++(ptr->m);
+    ++(get().m);
+    return *this;
+  }
+  Widget &Widget::operator+=(int n) {
+    get().m += n;
     return *this;
   }
+  int Widget::value() const { return get().m.data; }
+
+  void increment(Widget *widgets, std::size_t count, int n) {
+    for (std::size_t i = 0; i < count; ++i) {
+      widgets[i] += n; // inlined: same translation unit
+    }
+  }
+  void increment(Widget **widgets, std::size_t count, int n) {
+    for (std::size_t i = 0; i < count; ++i) {
+      *widgets[i] += n;
+    }
+  }
 
-}
\ No newline at end of file
+}
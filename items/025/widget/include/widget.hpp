@@ -1,13 +1,32 @@
 #pragma once
-#include <memory>
+#include <cstddef>
 
 namespace widget {
 
 struct Widget {
-  struct impl;
-  std::shared_ptr<impl> ptr;
+  struct impl; // defined in widget.cpp
+  // inline storage for 'impl' (fast pimpl): no heap allocation per Widget;
+  // widget.cpp checks that 'impl' fits into this storage
+  static constexpr std::size_t impl_size = 8;
+  static constexpr std::size_t impl_align = 8;
+  alignas(impl_align) unsigned char storage[impl_size];
   Widget();
+  Widget(const Widget &other);
+  Widget(Widget &&other) noexcept;
+  Widget &operator=(const Widget &other);
+  Widget &operator=(Widget &&other) noexcept;
+  ~Widget();
   Widget& operator++();
+  Widget &operator+=(int n); // n increments in a single library call
+  int value() const;
+
+private:
+  impl &get();
+  const impl &get() const;
 };
 
-}
\ No newline at end of file
+// batch interface: crosses the library boundary once per batch
+void increment(Widget *widgets, std::size_t count, int n = 1);
+void increment(Widget **widgets, std::size_t count, int n = 1);
+
+}
@@ -1,8 +1,49 @@
 #include "widget.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+template <typename CALLABLE>
+void track_time(const std::string &name, std::size_t elements,
+                CALLABLE &&func) {
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::duration<double>;
+  func(); // warmup
+  auto start = Clock::now();
+  func();
+  auto stop = Clock::now();
+  std::cout << name << ": " << std::scientific
+            << Duration(stop - start).count() / elements << "s per element"
+            << std::endl;
+}
+
 int main() {
   widget::Widget w;
   ++w;
   ++w;
   ++w;
+
+#ifndef DEBUGGING // Debug builds of widget print on each increment
+  const std::size_t N = 1'000'000;
+  const int n = 10;
+  std::vector<widget::Widget> widgets(N);
+  track_time("one call per increment", N * n, [&widgets] {
+    for (auto &&item : widgets) {
+      for (int i = 0; i < n; ++i) {
+        ++item;
+      }
+    }
+  });
+  track_time("one call per widget", N * n, [&widgets] {
+    for (auto &&item : widgets) {
+      item += n;
+    }
+  });
+  track_time("one call per batch", N * n, [&widgets] {
+    widget::increment(widgets.data(), widgets.size(), n);
+  });
+  std::cout << widgets.front().value() << std::endl;
+#endif
   return 0;
 }